@@ -0,0 +1,146 @@
+// Compares formatarMoedaBr/formatarMesAno with the stringstream versions they
+// replaced. Checks that both produce the same text for every sample, then
+// times each one over N values (default 10^8).
+//
+//   make bench && ./bench/bench_formatacao [N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Formatacao.h"
+
+using namespace std;
+
+namespace {
+
+string formatYearMonthAntigo(const YearMonth& ym) {
+    stringstream ss;
+    ss << setw(2) << setfill('0') << ym.getMonth() << "/"
+       << ym.getYear();
+    return ss.str();
+}
+
+string formatCurrencyBrAntigo(double value) {
+    stringstream ss;
+    ss << fixed << setprecision(2) << value;
+    string result = ss.str();
+
+    result.erase(remove(result.begin(), result.end(), ','), result.end());
+
+    size_t dot = result.find('.');
+    if (dot != string::npos) {
+        result[dot] = ',';
+    }
+
+    return "R$ " + result;
+}
+
+// Amounts that show up in the reports (whole cents, balances after interest)
+// plus the corner cases of the rounding: exact ties, values one ulp away from
+// a tie, negatives, zero and huge values
+vector<double> gerarValores(size_t quantidade, mt19937_64& gerador) {
+    uniform_int_distribution<int64_t> centavos(-100000000, 100000000);
+    uniform_real_distribution<double> real(-1e7, 1e7);
+    uniform_int_distribution<int> tipo(0, 7);
+
+    vector<double> valores = {0.0, -0.0, -0.004, 0.125, 1.005, 1e300};
+    valores.reserve(quantidade);
+    while (valores.size() < quantidade) {
+        switch (tipo(gerador)) {
+        case 0:
+        case 1:
+            valores.push_back(centavos(gerador) / 100.0);
+            break;
+        case 2:
+            valores.push_back(centavos(gerador) / 8.0);
+            break;
+        case 3: {
+            double empate = (centavos(gerador) + 0.5) / 100.0;
+            valores.push_back(nextafter(empate, gerador() & 1 ? 1e300 : -1e300));
+            break;
+        }
+        case 4:
+            valores.push_back((centavos(gerador) % 1000) / 1000.0);
+            break;
+        case 5:
+            valores.push_back(real(gerador) * 1e9);
+            break;
+        default:
+            valores.push_back(real(gerador));
+            break;
+        }
+    }
+    return valores;
+}
+
+template <typename Funcao>
+double medir(size_t n, Funcao funcao) {
+    auto inicio = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        funcao(i);
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+void relatar(const char* nome, size_t n, double antigo, double novo) {
+    cout << nome << ": stringstream " << fixed << setprecision(2) << antigo << " s ("
+         << antigo * 1e9 / n << " ns/valor), novo " << novo << " s ("
+         << novo * 1e9 / n << " ns/valor), " << antigo / novo << "x" << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000000;
+
+    mt19937_64 gerador(42);
+    vector<double> valores = gerarValores(1 << 20, gerador);
+
+    vector<YearMonth> meses;
+    for (int ano = 1990; ano < 2100; ano++) {
+        for (int mes = 1; mes <= 12; mes++) {
+            meses.emplace_back(ano, mes);
+        }
+    }
+
+    char texto[TAMANHO_MAX_MOEDA];
+    for (double valor : valores) {
+        string esperado = formatCurrencyBrAntigo(valor);
+        string obtido(texto, formatarMoedaBr(texto, valor));
+        if (esperado != obtido) {
+            cerr << setprecision(17) << "Divergência em " << valor << ": " << esperado << " != " << obtido << endl;
+            return 1;
+        }
+    }
+    for (const YearMonth& ym : meses) {
+        if (formatYearMonthAntigo(ym) != string(texto, formatarMesAno(texto, ym))) {
+            cerr << "Divergência em " << ym.getMonth() << "/" << ym.getYear() << endl;
+            return 1;
+        }
+    }
+    cout << valores.size() << " valores e " << meses.size() << " meses conferidos" << endl;
+
+    // The lengths are summed so the compiler cannot drop the calls
+    size_t total = 0;
+    size_t mascara = valores.size() - 1;
+
+    double antigo = medir(n, [&](size_t i) { total += formatCurrencyBrAntigo(valores[i & mascara]).size(); });
+    double novo = medir(n, [&](size_t i) { total += formatarMoedaBr(texto, valores[i & mascara]) - texto; });
+    relatar("moeda", n, antigo, novo);
+
+    antigo = medir(n, [&](size_t i) { total += formatYearMonthAntigo(meses[i % meses.size()]).size(); });
+    novo = medir(n, [&](size_t i) { total += formatarMesAno(texto, meses[i % meses.size()]) - texto; });
+    relatar("mês/ano", n, antigo, novo);
+
+    cerr << "(" << total << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Compares simularPoupancas (SIMD lanes) with the scalar loop. Checks that
+// both give the same balances for random couples, including balances near
+// and beyond the lane range and interest ties, then times each one over N
+// couples (default 10^5) of up to 600 months, in blocks of 64 couples as
+// process_files plans them.
+//
+//   make bench && ./bench/bench_poupanca [N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Poupanca.h"
+
+using namespace std;
+
+namespace {
+
+struct Amostra {
+    vector<ContaPoupanca> contas;
+    vector<vector<Dinheiro>> variacoes;
+    vector<vector<Dinheiro>> saldos;
+};
+
+Amostra gerarAmostra(size_t quantidade, mt19937_64& gerador) {
+    uniform_int_distribution<int64_t> centavos(-100000000, 100000000);
+    uniform_int_distribution<int64_t> enorme(-(int64_t(1) << 52), int64_t(1) << 52);
+    uniform_int_distribution<size_t> meses(0, 600);
+    uniform_int_distribution<int> mes(24000, 24400);
+    uniform_int_distribution<int> tipo(0, 15);
+
+    Amostra amostra;
+    amostra.contas.resize(quantidade);
+    amostra.variacoes.resize(quantidade);
+    amostra.saldos.resize(quantidade);
+    for (size_t i = 0; i < quantidade; i++) {
+        ContaPoupanca& conta = amostra.contas[i];
+        int t = tipo(gerador);
+        // Balances that cross the lane range, and multiples of 100 cents that
+        // make the interest land on a tie
+        int64_t inicial = t == 0 ? enorme(gerador) : t == 1 ? centavos(gerador) / 100 * 100 : centavos(gerador);
+        conta.saldoInicial = Dinheiro::deCentavos(inicial);
+        conta.salario = Dinheiro::deCentavos(centavos(gerador) / 100);
+        conta.decimoTerceiro = Dinheiro::deCentavos(max<int64_t>(conta.salario.getCentavos(), 0));
+        conta.gastosMensais = Dinheiro::deCentavos(centavos(gerador) / 1000);
+        conta.primeiroMes = mes(gerador);
+        conta.numMeses = meses(gerador);
+
+        vector<Dinheiro>& variacao = amostra.variacoes[i];
+        for (size_t m = 0; m < conta.numMeses; m++) {
+            variacao.push_back(Dinheiro::deCentavos(m % 7 == 0 ? centavos(gerador) / 100 : 0));
+        }
+        amostra.saldos[i].resize(conta.numMeses);
+        conta.variacao = variacao.data();
+        conta.saldos = amostra.saldos[i].data();
+    }
+    return amostra;
+}
+
+template <typename Funcao>
+double medirSegundos(Funcao funcao) {
+    auto inicio = chrono::steady_clock::now();
+    funcao();
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t quantidade = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    mt19937_64 gerador(42);
+
+    Amostra escalar = gerarAmostra(quantidade, gerador);
+    Amostra lanes = escalar;
+    for (size_t i = 0; i < quantidade; i++) {
+        lanes.contas[i].variacao = lanes.variacoes[i].data();
+        lanes.contas[i].saldos = lanes.saldos[i].data();
+    }
+
+    // Same block size as process_files
+    const size_t TAMANHO_BLOCO = 64;
+    double tempoEscalar = medirSegundos([&] {
+        for (size_t i = 0; i < quantidade; i += TAMANHO_BLOCO) {
+            simularPoupancasEscalar(escalar.contas.data() + i, min(TAMANHO_BLOCO, quantidade - i));
+        }
+    });
+    double tempoLanes = medirSegundos([&] {
+        for (size_t i = 0; i < quantidade; i += TAMANHO_BLOCO) {
+            simularPoupancas(lanes.contas.data() + i, min(TAMANHO_BLOCO, quantidade - i));
+        }
+    });
+
+    size_t meses = 0;
+    for (size_t i = 0; i < quantidade; i++) {
+        meses += escalar.contas[i].numMeses;
+        if (escalar.saldos[i] != lanes.saldos[i]) {
+            cerr << "Balances differ for account " << i << endl;
+            return 1;
+        }
+    }
+
+    cout << quantidade << " couples, " << meses << " months" << endl;
+    cout << "scalar: " << tempoEscalar << " s" << endl;
+    cout << "lanes:  " << tempoLanes << " s (" << tempoEscalar / tempoLanes << "x)" << endl;
+    return 0;
+}
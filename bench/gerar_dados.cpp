@@ -0,0 +1,300 @@
+// Writes a synthetic dataset (pessoas, lares, casamentos, festas, tarefas,
+// compras and the CPF pairs of entrada.txt) for CASAIS couples. The output
+// only depends on the arguments: every value comes from a seeded splitmix64
+// stream, never from the standard library distributions.
+//
+//   ./bench/gerar_dados PASTA CASAIS [--semente N] [--parcelas N] [--convidados N]
+//
+// About 8.5 rows per couple: CASAIS = 1200 gives ~10^4 rows, 1200000 gives
+// ~10^7. Guest lists pick names with a power-law skew, so a few people are
+// invited to a large share of the festas; tarefas and compras are split in
+// up to --parcelas parcels (default 240, twenty years).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+uint64_t misturar(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+class Gerador {
+private:
+    uint64_t estado;
+
+public:
+    explicit Gerador(uint64_t semente) : estado(semente) {}
+
+    uint64_t proximo() {
+        estado += 0x9e3779b97f4a7c15ULL;
+        return misturar(estado);
+    }
+
+    // Uniform in [minimo, maximo]
+    int64_t entre(int64_t minimo, int64_t maximo) {
+        return minimo + static_cast<int64_t>(proximo() % static_cast<uint64_t>(maximo - minimo + 1));
+    }
+
+    // Uniform in [0, 1)
+    double real() { return static_cast<double>(proximo() >> 11) * 0x1.0p-53; }
+
+    bool chance(double p) { return real() < p; }
+};
+
+// Buffered output file; exits on I/O errors
+class Saida {
+private:
+    FILE* arquivo;
+    string buffer;
+
+public:
+    explicit Saida(const string& caminho) : arquivo(fopen(caminho.c_str(), "wb")) {
+        if (!arquivo) {
+            cerr << "Cannot write " << caminho << endl;
+            exit(1);
+        }
+        buffer.reserve(1 << 20);
+    }
+
+    ~Saida() {
+        descarregar();
+        fclose(arquivo);
+    }
+
+    void descarregar() {
+        if (fwrite(buffer.data(), 1, buffer.size(), arquivo) != buffer.size()) {
+            cerr << "Write failed" << endl;
+            exit(1);
+        }
+        buffer.clear();
+    }
+
+    Saida& operator<<(const string& texto) {
+        buffer += texto;
+        return *this;
+    }
+
+    Saida& operator<<(const char* texto) {
+        buffer += texto;
+        return *this;
+    }
+
+    Saida& operator<<(char c) {
+        buffer += c;
+        return *this;
+    }
+
+    Saida& operator<<(int64_t valor) {
+        buffer += to_string(valor);
+        return *this;
+    }
+
+    // Ends a row
+    void fimDeLinha() {
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) {
+            descarregar();
+        }
+    }
+};
+
+// 32 hex digits, distinct for every (tipo, i): the mix is a bijection
+string id(uint64_t tipo, uint64_t i) {
+    static const char HEX[] = "0123456789abcdef";
+    uint64_t alto = misturar((tipo << 48) | i);
+    uint64_t baixo = misturar(alto ^ tipo);
+    string texto(32, '0');
+    for (int d = 0; d < 16; d++) {
+        texto[d] = HEX[(alto >> (60 - 4 * d)) & 0xF];
+        texto[16 + d] = HEX[(baixo >> (60 - 4 * d)) & 0xF];
+    }
+    return texto;
+}
+
+enum : uint64_t { PESSOA = 1, LAR, CASAMENTO, FESTA, TAREFA, COMPRA };
+
+string cpf(uint64_t i) {
+    char texto[24];
+    snprintf(texto, sizeof(texto), "%011llu", static_cast<unsigned long long>(i));
+    return texto;
+}
+
+string cnpj(uint64_t i, int filial) {
+    char texto[40];
+    snprintf(texto, sizeof(texto), "%08llu/%04d-%02llu", static_cast<unsigned long long>(i), filial,
+             static_cast<unsigned long long>(i % 100));
+    return texto;
+}
+
+string nomePessoa(uint64_t i) {
+    return "Pessoa " + to_string(i);
+}
+
+// Brazilian decimal, cents between minimo and maximo
+string dinheiro(Gerador& gerador, int64_t minimo, int64_t maximo) {
+    int64_t centavos = gerador.entre(minimo, maximo);
+    char texto[32];
+    snprintf(texto, sizeof(texto), "%lld,%02lld", static_cast<long long>(centavos / 100),
+             static_cast<long long>(centavos % 100));
+    return texto;
+}
+
+string data(Gerador& gerador) {
+    char texto[16];
+    snprintf(texto, sizeof(texto), "%02d/%02d/%d", static_cast<int>(gerador.entre(1, 28)),
+             static_cast<int>(gerador.entre(1, 12)), static_cast<int>(gerador.entre(2025, 2034)));
+    return texto;
+}
+
+void uso(const char* programa) {
+    cerr << "Usage: " << programa << " <folder> <couples> [--semente N] [--parcelas N] [--convidados N]" << endl;
+    exit(1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        uso(argv[0]);
+    }
+    string pasta = argv[1];
+    uint64_t casais = strtoull(argv[2], nullptr, 10);
+    uint64_t semente = 1;
+    int64_t maxParcelas = 240;
+    int64_t maxConvidados = 40;
+    for (int i = 3; i < argc; i++) {
+        string opcao = argv[i];
+        if (i + 1 >= argc) {
+            uso(argv[0]);
+        }
+        if (opcao == "--semente") {
+            semente = strtoull(argv[++i], nullptr, 10);
+        } else if (opcao == "--parcelas") {
+            maxParcelas = strtoll(argv[++i], nullptr, 10);
+        } else if (opcao == "--convidados") {
+            maxConvidados = strtoll(argv[++i], nullptr, 10);
+        } else {
+            uso(argv[0]);
+        }
+    }
+    if (casais == 0 || maxParcelas < 1 || maxConvidados < 1) {
+        uso(argv[0]);
+    }
+
+    filesystem::create_directories(pasta);
+    Gerador gerador(semente);
+
+    uint64_t numFisicas = 2 * casais;
+    uint64_t numPrestadores = max<uint64_t>(3, casais / 5);
+    uint64_t numLojas = max<uint64_t>(3, casais / 5);
+
+    // Pessoas: the PF of couple c are 2c and 2c + 1; PJ and Loja follow
+    {
+        Saida pessoas(pasta + "/pessoas.csv");
+        for (uint64_t i = 0; i < numFisicas; i++) {
+            pessoas << id(PESSOA, i) << ";F;" << nomePessoa(i) << ";(11) 90000-0000;Rua " << static_cast<int64_t>(i)
+                    << ", 1, São Paulo, SP;" << cpf(i) << ";01/01/1990;" << dinheiro(gerador, 0, 50000000) << ';'
+                    << dinheiro(gerador, 100000, 3000000) << ';' << dinheiro(gerador, 50000, 1500000);
+            pessoas.fimDeLinha();
+        }
+        for (uint64_t i = 0; i < numPrestadores; i++) {
+            pessoas << id(PESSOA, numFisicas + i) << ";J;Empresa " << static_cast<int64_t>(i)
+                    << ";(11) 30000-0000;Avenida Paulista, 1000, São Paulo, SP;" << cnpj(i, 1);
+            pessoas.fimDeLinha();
+        }
+        for (uint64_t i = 0; i < numLojas; i++) {
+            pessoas << id(PESSOA, numFisicas + numPrestadores + i) << ";L;Loja " << static_cast<int64_t>(i)
+                    << ";(11) 30000-0000;Rua Augusta, 500, São Paulo, SP;" << cnpj(i, 2);
+            pessoas.fimDeLinha();
+        }
+    }
+
+    Saida lares(pasta + "/lares.csv");
+    Saida casamentos(pasta + "/casamentos.csv");
+    Saida festas(pasta + "/festas.csv");
+    Saida tarefas(pasta + "/tarefas.csv");
+    Saida compras(pasta + "/compras.csv");
+    uint64_t numFestas = 0;
+    uint64_t numTarefas = 0;
+    uint64_t numCompras = 0;
+
+    for (uint64_t c = 0; c < casais; c++) {
+        string pessoa1 = id(PESSOA, 2 * c);
+        string pessoa2 = id(PESSOA, 2 * c + 1);
+        if (gerador.chance(0.5)) {
+            swap(pessoa1, pessoa2);
+        }
+
+        string idLar = id(LAR, c);
+        lares << idLar << ';' << pessoa1 << ';' << pessoa2 << ";Rua das Flores;" << static_cast<int64_t>(c)
+              << ";Apto 1";
+        lares.fimDeLinha();
+
+        string idCasamento = id(CASAMENTO, c);
+        casamentos << idCasamento << ';' << pessoa1 << ';' << pessoa2 << ';' << data(gerador)
+                   << ";15:00;Igreja São José";
+        casamentos.fimDeLinha();
+
+        for (int64_t t = gerador.entre(0, 3); t > 0; t--) {
+            string idTarefa = id(TAREFA, numTarefas++);
+            // Most tarefas go to a PJ, some to one of the first PF
+            uint64_t prestador = gerador.chance(0.8) ? numFisicas + gerador.proximo() % numPrestadores
+                                                     : gerador.proximo() % min<uint64_t>(numFisicas, 10);
+            tarefas << idTarefa << ';' << idLar << ';' << id(PESSOA, prestador) << ';' << data(gerador) << ';'
+                    << gerador.entre(1, 90) << ';' << dinheiro(gerador, 10000, 5000000) << ';'
+                    << gerador.entre(1, maxParcelas);
+            tarefas.fimDeLinha();
+
+            for (int64_t k = gerador.entre(0, 2); k > 0; k--) {
+                uint64_t loja = numFisicas + numPrestadores + gerador.proximo() % numLojas;
+                compras << id(COMPRA, numCompras++) << ';' << idTarefa << ';' << id(PESSOA, loja) << ";Produto;"
+                        << gerador.entre(1, 5) << ';' << dinheiro(gerador, 1000, 500000) << ';'
+                        << gerador.entre(1, maxParcelas);
+                compras.fimDeLinha();
+            }
+        }
+
+        for (int64_t f = gerador.entre(0, 2); f > 0; f--) {
+            festas << id(FESTA, numFestas++) << ';' << idCasamento << ";Salão de Festas;" << data(gerador)
+                   << ";20:00;" << dinheiro(gerador, 50000, 10000000) << ';' << gerador.entre(1, 12) << ';';
+            // u^3 piles the picks on the first names
+            int64_t convidados = gerador.entre(1, maxConvidados);
+            for (int64_t g = 0; g < convidados; g++) {
+                double u = gerador.real();
+                uint64_t convidado = static_cast<uint64_t>(static_cast<double>(numFisicas) * u * u * u);
+                festas << (g > 0 ? "," : "") << nomePessoa(convidado);
+            }
+            if (gerador.chance(0.3)) {
+                festas << ',' << nomePessoa(2 * c) << ',' << nomePessoa(2 * c + 1);
+            }
+            festas.fimDeLinha();
+        }
+    }
+
+    // CPF pairs: a third more lines than couples, so some couples repeat,
+    // in either order
+    Saida entrada(pasta + "/entrada.txt");
+    for (uint64_t i = 0; i < casais + casais / 3; i++) {
+        uint64_t c = gerador.proximo() % casais;
+        bool trocar = gerador.chance(0.5);
+        entrada << cpf(2 * c + (trocar ? 1 : 0)) << ", " << cpf(2 * c + (trocar ? 0 : 1));
+        entrada.fimDeLinha();
+    }
+
+    cout << casais << " couples: " << numFisicas + numPrestadores + numLojas << " pessoas, " << casais << " lares, "
+         << casais << " casamentos, " << numFestas << " festas, " << numTarefas << " tarefas, " << numCompras
+         << " compras" << endl;
+    return 0;
+}
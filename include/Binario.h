@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Helpers shared by the binary cache files kept in the input folder (the
+// dataset snapshot and the plan cache). Numbers are stored in native byte
+// order and text is length-prefixed. Every file starts with the same
+// header: an 8-byte magic, a format version, a byte-order mark, the body
+// size and a resumo64 digest of the body.
+
+// Raised by LeitorBinario on truncated or inconsistent data
+struct DadosBinariosInvalidos : std::runtime_error {
+    DadosBinariosInvalidos() : std::runtime_error("Dados binarios invalidos") {}
+};
+
+template <typename T>
+void anexarNumero(std::string& destino, T valor) {
+    static_assert(std::is_arithmetic_v<T>);
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &valor, sizeof(T));
+    destino.append(bytes, sizeof(T));
+}
+
+inline void anexarTexto(std::string& destino, std::string_view texto) {
+    anexarNumero(destino, static_cast<std::uint32_t>(texto.size()));
+    destino.append(texto);
+}
+
+// Bounds-checked reader over a byte range
+class LeitorBinario {
+private:
+    std::string_view resto;
+
+public:
+    explicit LeitorBinario(std::string_view dados) : resto(dados) {}
+
+    bool fim() const { return resto.empty(); }
+
+    template <typename T>
+    T numero() {
+        static_assert(std::is_arithmetic_v<T>);
+        if (resto.size() < sizeof(T)) {
+            throw DadosBinariosInvalidos();
+        }
+        T valor;
+        std::memcpy(&valor, resto.data(), sizeof(T));
+        resto.remove_prefix(sizeof(T));
+        return valor;
+    }
+
+    std::string_view bytes(size_t tamanho) {
+        if (resto.size() < tamanho) {
+            throw DadosBinariosInvalidos();
+        }
+        std::string_view trecho = resto.substr(0, tamanho);
+        resto.remove_prefix(tamanho);
+        return trecho;
+    }
+
+    std::string_view texto() { return bytes(numero<std::uint32_t>()); }
+};
+
+// Body of a file with the given magic and version, or nothing when the
+// header does not match or the body digest is wrong
+std::optional<std::string_view> abrirCorpoBinario(std::string_view arquivo, std::string_view magico,
+                                                  std::uint32_t versao);
+
+// Writes header and body to caminho through a temporary file and a rename,
+// so readers never see a partial file. Throws runtime_error on failure.
+void gravarArquivoBinario(const std::string& caminho, std::string_view magico, std::uint32_t versao,
+                          std::string_view corpo);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Entidades.h"
+#include "LeitorCSV.h"
+
+// 128-bit digest of everything a couple's timeline and balances depend on:
+// both people's savings, salaries and monthly costs, and the start, total
+// and parcel count of every expense gathered from their lares, tarefas,
+// compras, casamentos and festas. Equal keys mean equal plans.
+struct ChavePlano {
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+
+    bool operator==(const ChavePlano&) const = default;
+};
+
+template <>
+struct std::hash<ChavePlano> {
+    size_t operator()(const ChavePlano& chave) const noexcept { return chave.a; }
+};
+
+// Timelines and balances of the couples planned by an earlier run, kept in
+// the input folder next to the dataset snapshot. Entries stay in the mapped
+// file and are decoded on a hit. Lookups are read-only, so couples can be
+// planned in parallel against the same cache.
+class CachePlanos {
+public:
+    static constexpr const char* NOME_ARQUIVO = "planos.cache";
+    static constexpr std::uint32_t VERSAO = 1;
+
+private:
+    ArquivoMapeado arquivo;
+    std::unordered_map<ChavePlano, std::string_view> entradas;
+
+public:
+    // A missing or damaged file gives an empty cache
+    explicit CachePlanos(const std::string& caminho);
+
+    CachePlanos(const CachePlanos&) = delete;
+    CachePlanos& operator=(const CachePlanos&) = delete;
+
+    size_t size() const { return entradas.size(); }
+
+    // Fills timeline and saldos from the entry for chave; false if absent
+    bool buscar(ChavePlano chave, std::vector<YearMonth>& timeline, std::vector<Dinheiro>& saldos) const;
+};
+
+// Collects the plans of a run and writes them as the next cache
+class GravadorCachePlanos {
+private:
+    std::string corpo;
+    std::uint32_t numEntradas = 0;
+    std::unordered_set<ChavePlano> vistas;
+
+public:
+    // Plans with a key already added are skipped
+    void adicionar(ChavePlano chave, const std::vector<YearMonth>& timeline, const std::vector<Dinheiro>& saldos);
+
+    // Replaces the file at caminho; throws runtime_error on I/O failure
+    void gravar(const std::string& caminho) const;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Entidades.h"
+
+// Owns every Pessoa of the input, each kind in its own contiguous array.
+// The file order is kept as tagged references (kind + position in that
+// kind's array) and exposed as pointers once loading is over. All people
+// are released at once with the store.
+class CadastroPessoas {
+public:
+    struct Referencia {
+        TipoPessoa tipo;
+        std::uint32_t posicao;
+    };
+
+private:
+    std::vector<PessoaFisica> fisicas;
+    std::vector<PessoaJuridica> juridicas;
+    std::vector<Loja> lojas;
+    std::vector<Referencia> ordem;
+    std::vector<Pessoa*> pessoas;
+
+    void indexar();
+
+public:
+    CadastroPessoas() = default;
+    CadastroPessoas(const CadastroPessoas&) = delete;
+    CadastroPessoas& operator=(const CadastroPessoas&) = delete;
+    CadastroPessoas(CadastroPessoas&&) = default;
+    CadastroPessoas& operator=(CadastroPessoas&&) = default;
+
+    void adicionar(PessoaFisica&& pessoa);
+    void adicionar(PessoaJuridica&& pessoa);
+    void adicionar(Loja&& pessoa);
+
+    // Appends the rows of every part, in order, and rebuilds getPessoas()
+    void anexar(std::vector<CadastroPessoas>& partes);
+
+    size_t size() const { return ordem.size(); }
+    Pessoa* get(Referencia referencia);
+
+    // Every Pessoa in file order. Only up to date after anexar: adicionar
+    // may move the arrays and does not refresh it
+    const std::vector<Pessoa*>& getPessoas() const { return pessoas; }
+};
+
+// Destination hook used by CargaCSV to collect the parsed slices
+inline void anexarPartes(CadastroPessoas& destino, std::vector<CadastroPessoas>& partes) {
+    destino.anexar(partes);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LeitorCSV.h"
+#include "ThreadPool.h"
+
+// Appends parsed slices, in file order, to a vector destination. Other
+// destination types provide their own overload next to their definition.
+template <typename T>
+void anexarPartes(std::vector<T>& destino, std::vector<std::vector<T>>& partes) {
+    size_t total = destino.size();
+    for (const std::vector<T>& parte : partes) {
+        total += parte.size();
+    }
+    destino.reserve(total);
+    for (std::vector<T>& parte : partes) {
+        destino.insert(destino.end(), std::make_move_iterator(parte.begin()),
+                       std::make_move_iterator(parte.end()));
+    }
+}
+
+// Parses one input file on a thread pool. The mapped file is cut at line
+// boundaries into slices, every slice is parsed by a worker into its own
+// Destino, and concluir() appends the slices to the destination in file order.
+template <typename Destino>
+class CargaCSV {
+public:
+    using Leitor = void (*)(std::string_view trecho, Destino& destino);
+
+    // Slices smaller than this are not worth a task of their own
+    static constexpr size_t TAMANHO_MINIMO_TRECHO = 1 << 20;
+
+private:
+    ArquivoMapeado arquivo;
+    std::vector<Destino> partes;
+    std::vector<std::future<void>> tarefas;
+
+public:
+    CargaCSV(const std::string& caminho, Leitor ler, ThreadPool& pool) : arquivo(caminho) {
+        if (!arquivo.is_open()) {
+            throw std::runtime_error("Erro de I/O");
+        }
+
+        std::vector<std::string_view> trechos =
+            dividirEmTrechos(arquivo.conteudo(), pool.getNumThreads(), TAMANHO_MINIMO_TRECHO);
+        partes.resize(trechos.size());
+        for (size_t i = 0; i < trechos.size(); i++) {
+            tarefas.push_back(pool.submeter([ler, trecho = trechos[i], &parte = partes[i]]() {
+                ler(trecho, parte);
+            }));
+        }
+    }
+
+    // Waits for every slice; rethrows the first parse error in file order
+    void concluir(Destino& destino) {
+        for (std::future<void>& tarefa : tarefas) {
+            tarefa.wait();
+        }
+        for (std::future<void>& tarefa : tarefas) {
+            tarefa.get();
+        }
+
+        anexarPartes(destino, partes);
+        partes.clear();
+    }
+
+    // Waits without collecting results, so no task outlives the mapping
+    ~CargaCSV() {
+        for (std::future<void>& tarefa : tarefas) {
+            if (tarefa.valid()) {
+                tarefa.wait();
+            }
+        }
+    }
+};
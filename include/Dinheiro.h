@@ -0,0 +1,68 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+// Amount of money as a whole number of cents. Sums, differences and
+// multiples are exact, so totals do not depend on the order (or the thread)
+// in which they are added up.
+class Dinheiro {
+private:
+    std::int64_t centavos = 0;
+
+    constexpr explicit Dinheiro(std::int64_t centavos) : centavos(centavos) {}
+
+public:
+    constexpr Dinheiro() = default;
+
+    static constexpr Dinheiro deCentavos(std::int64_t centavos) { return Dinheiro(centavos); }
+
+    constexpr std::int64_t getCentavos() const { return centavos; }
+
+    // Monthly interest of the savings account: 0.5% of the amount, rounded to
+    // the cent with ties away from zero
+    constexpr Dinheiro jurosMensais() const {
+        std::int64_t juros = centavos / 200;
+        std::int64_t resto = centavos % 200;
+        if (resto >= 100) {
+            juros++;
+        } else if (resto <= -100) {
+            juros--;
+        }
+        return Dinheiro(juros);
+    }
+
+    // Parcel i (0-based) of the amount split into n > 0 parcels. The parcels
+    // add up to the amount exactly: the first parcelasMaiores(n) of them carry
+    // the leftover cents, one each.
+    constexpr Dinheiro parcela(int i, int n) const {
+        std::int64_t base = centavos / n;
+        std::int64_t resto = centavos % n;
+        if (i < (resto < 0 ? -resto : resto)) {
+            base += resto < 0 ? -1 : 1;
+        }
+        return Dinheiro(base);
+    }
+
+    constexpr int parcelasMaiores(int n) const {
+        std::int64_t resto = centavos % n;
+        return static_cast<int>(resto < 0 ? -resto : resto);
+    }
+
+    constexpr Dinheiro operator+(Dinheiro outro) const { return Dinheiro(centavos + outro.centavos); }
+    constexpr Dinheiro operator-(Dinheiro outro) const { return Dinheiro(centavos - outro.centavos); }
+    constexpr Dinheiro operator-() const { return Dinheiro(-centavos); }
+    constexpr Dinheiro operator*(std::int64_t fator) const { return Dinheiro(centavos * fator); }
+
+    constexpr Dinheiro& operator+=(Dinheiro outro) {
+        centavos += outro.centavos;
+        return *this;
+    }
+
+    constexpr Dinheiro& operator-=(Dinheiro outro) {
+        centavos -= outro.centavos;
+        return *this;
+    }
+
+    constexpr auto operator<=>(const Dinheiro&) const = default;
+};
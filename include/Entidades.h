@@ -0,0 +1,341 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Dinheiro.h"
+#include "Simbolo.h"
+
+class YearMonth {
+private:
+    int year;
+    int month;
+
+public:
+    YearMonth(int year, int month) : year(year), month(month) {}
+
+    int getYear() const { return year; }
+    int getMonth() const { return month; }
+
+    // Months since January of year 0, used as a dense array index
+    int toAbsoluteMonth() const { return year * 12 + month - 1; }
+
+    static YearMonth fromAbsoluteMonth(int absoluteMonth) {
+        return YearMonth(absoluteMonth / 12, absoluteMonth % 12 + 1);
+    }
+
+    YearMonth plusMonths(int months) const {
+        int totalMonths = year * 12 + month - 1 + months;
+        int newYear = totalMonths / 12;
+        int newMonth = totalMonths % 12 + 1;
+        return YearMonth(newYear, newMonth);
+    }
+
+    bool isAfter(const YearMonth& other) const {
+        return (year > other.year) || (year == other.year && month > other.month);
+    }
+
+    bool operator<(const YearMonth& other) const {
+        return (year < other.year) || (year == other.year && month < other.month);
+    }
+
+    bool operator==(const YearMonth& other) const {
+        return year == other.year && month == other.month;
+    }
+};
+
+// A cost paid in numParcels monthly parcels from start on; see Dinheiro::parcela
+class Expense {
+public:
+    YearMonth start;
+    Dinheiro total;
+    int numParcels;
+
+    Expense(YearMonth start, Dinheiro total, int numParcels)
+        : start(start), total(total), numParcels(numParcels) {}
+};
+
+inline YearMonth parseDateToYearMonth(const std::string& date) {
+    int year = std::stoi(date.substr(6, 4));
+    int month = std::stoi(date.substr(3, 2));
+    return YearMonth(year, month);
+}
+
+class Casal {
+private:
+    std::string nome1;
+    std::string nome2;
+
+public:
+    Casal(std::string nome1, std::string nome2) {
+        if (nome2 < nome1) {
+            this->nome1 = nome2;
+            this->nome2 = nome1;
+        } else {
+            this->nome1 = nome1;
+            this->nome2 = nome2;
+        }
+    }
+
+    bool operator<(const Casal& other) const {
+        if (nome1 != other.nome1) {
+            return nome1 < other.nome1;
+        }
+        return nome2 < other.nome2;
+    }
+
+    std::string getNome1() const { return nome1; }
+    std::string getNome2() const { return nome2; }
+
+    void setNome1(const std::string& nome1) { this->nome1 = nome1; }
+    void setNome2(const std::string& nome2) { this->nome2 = nome2; }
+};
+
+// Concrete kind of a Pessoa, stored in the base so a type test is a plain
+// comparison instead of a virtual call
+enum class TipoPessoa : std::uint8_t { Fisica, Juridica, Loja };
+
+// Not polymorphic: objects are owned by CadastroPessoas in one array per
+// kind and are never deleted through a Pessoa*
+class Pessoa {
+private:
+    TipoPessoa tipoPessoa;
+    Simbolo id;
+    std::string tipo;
+    Simbolo nome;
+    std::string telefone;
+    std::string endereco;
+
+protected:
+    Pessoa(TipoPessoa tipoPessoa, Simbolo id, std::string tipo, Simbolo nome, std::string telefone, std::string endereco)
+        : tipoPessoa(tipoPessoa), id(id), tipo(std::move(tipo)), nome(nome), telefone(std::move(telefone)),
+          endereco(std::move(endereco)) {}
+
+public:
+    Simbolo getId() const { return id; }
+    std::string getTipo() const { return tipo; }
+    Simbolo getNome() const { return nome; }
+    std::string getTelefone() const { return telefone; }
+    std::string getEndereco() const { return endereco; }
+    TipoPessoa getTipoPessoa() const { return tipoPessoa; }
+    bool isPessoaFisica() const { return tipoPessoa == TipoPessoa::Fisica; }
+    bool isPessoaJuridica() const { return tipoPessoa == TipoPessoa::Juridica; }
+    bool isLoja() const { return tipoPessoa == TipoPessoa::Loja; }
+
+    void setId(Simbolo id) { this->id = id; }
+    void setTipo(const std::string& tipo) { this->tipo = tipo; }
+    void setNome(Simbolo nome) { this->nome = nome; }
+    void setTelefone(const std::string& telefone) { this->telefone = telefone; }
+    void setEndereco(const std::string& endereco) { this->endereco = endereco; }
+};
+
+class PessoaFisica : public Pessoa {
+private:
+    Simbolo cpf;
+    std::string dataNascimento;
+    Dinheiro dinheiroGuardado;
+    Dinheiro salario;
+    Dinheiro gastosMensais;
+
+public:
+    PessoaFisica(Simbolo id, std::string tipo, Simbolo nome, std::string telefone, std::string endereco,
+                 Simbolo cpf, std::string dataNascimento, Dinheiro dinheiroGuardado, Dinheiro salario, Dinheiro gastosMensais)
+        : Pessoa(TipoPessoa::Fisica, id, std::move(tipo), nome, std::move(telefone), std::move(endereco)), cpf(cpf), dataNascimento(std::move(dataNascimento)),
+          dinheiroGuardado(dinheiroGuardado), salario(salario), gastosMensais(gastosMensais) {}
+
+    Simbolo getCpf() const { return cpf; }
+    std::string getDataNascimento() const { return dataNascimento; }
+    Dinheiro getDinheiroGuardado() const { return dinheiroGuardado; }
+    Dinheiro getSalario() const { return salario; }
+    Dinheiro getGastosMensais() const { return gastosMensais; }
+
+    void setCpf(Simbolo cpf) { this->cpf = cpf; }
+    void setDataNascimento(const std::string& dataNascimento) { this->dataNascimento = dataNascimento; }
+    void setDinheiroGuardado(Dinheiro dinheiroGuardado) { this->dinheiroGuardado = dinheiroGuardado; }
+    void setSalario(Dinheiro salario) { this->salario = salario; }
+    void setGastosMensais(Dinheiro gastosMensais) { this->gastosMensais = gastosMensais; }
+};
+
+class PessoaJuridica : public Pessoa {
+private:
+    Simbolo cnpj;
+
+public:
+    PessoaJuridica(Simbolo id, std::string tipo, Simbolo nome, std::string telefone, std::string endereco, Simbolo cnpj)
+        : Pessoa(TipoPessoa::Juridica, id, std::move(tipo), nome, std::move(telefone), std::move(endereco)), cnpj(cnpj) {}
+
+    Simbolo getCnpj() const { return cnpj; }
+
+    void setCnpj(Simbolo cnpj) { this->cnpj = cnpj; }
+};
+
+
+class Loja : public Pessoa {
+private:
+    Simbolo cnpj;
+
+public:
+    Loja(Simbolo id, std::string tipo, Simbolo nome, std::string telefone, std::string endereco, Simbolo cnpj)
+        : Pessoa(TipoPessoa::Loja, id, std::move(tipo), nome, std::move(telefone), std::move(endereco)), cnpj(cnpj) {}
+
+    Simbolo getCnpj() const { return cnpj; }
+
+    void setCnpj(Simbolo cnpj) { this->cnpj = cnpj; }
+
+};
+
+class Casamento {
+private:
+    Simbolo idCasamento;
+    Simbolo id1;
+    Simbolo id2;
+    std::string data;
+    std::string hora;
+    std::string local;
+
+public:
+    Casamento(Simbolo idCasamento, Simbolo id1, Simbolo id2, std::string data, std::string hora, std::string local)
+        : idCasamento(idCasamento), id1(id1), id2(id2), data(std::move(data)), hora(std::move(hora)), local(std::move(local)) {}
+
+    Simbolo getIdCasamento() const { return idCasamento; }
+    Simbolo getId1() const { return id1; }
+    Simbolo getId2() const { return id2; }
+    std::string getData() const { return data; }
+    std::string getHora() const { return hora; }
+    std::string getLocal() const { return local; }
+
+    void setIdCasamento(Simbolo idCasamento) { this->idCasamento = idCasamento; }
+    void setId1(Simbolo id1) { this->id1 = id1; }
+    void setId2(Simbolo id2) { this->id2 = id2; }
+    void setData(const std::string& data) { this->data = data; }
+    void setHora(const std::string& hora) { this->hora = hora; }
+    void setLocal(const std::string& local) { this->local = local; }
+};
+
+class Compra {
+private:
+    Simbolo id;
+    Simbolo idTarefa;
+    Simbolo idLoja;
+    std::string nomeProduto;
+    int qtdeProduto;
+    Dinheiro precoUnitario;
+    int numeroParcelas;
+
+public:
+    Compra(Simbolo id, Simbolo idTarefa, Simbolo idLoja, std::string nomeProduto, int qtdeProduto, Dinheiro precoUnitario, int numeroParcelas)
+        : id(id), idTarefa(idTarefa), idLoja(idLoja), nomeProduto(std::move(nomeProduto)), qtdeProduto(qtdeProduto),
+          precoUnitario(precoUnitario), numeroParcelas(numeroParcelas) {}
+
+    Simbolo getId() const { return id; }
+    Simbolo getIdTarefa() const { return idTarefa; }
+    Simbolo getIdLoja() const { return idLoja; }
+    std::string getNomeProduto() const { return nomeProduto; }
+    int getQtdeProduto() const { return qtdeProduto; }
+    Dinheiro getPrecoUnitario() const { return precoUnitario; }
+    int getNumeroParcelas() const { return numeroParcelas; }
+
+    void setId(Simbolo id) { this->id = id; }
+    void setIdTarefa(Simbolo idTarefa) { this->idTarefa = idTarefa; }
+    void setIdLoja(Simbolo idLoja) { this->idLoja = idLoja; }
+    void setNomeProduto(const std::string& nomeProduto) { this->nomeProduto = nomeProduto; }
+    void setQtdeProduto(int qtdeProduto) { this->qtdeProduto = qtdeProduto; }
+    void setPrecoUnitario(Dinheiro precoUnitario) { this->precoUnitario = precoUnitario; }
+    void setNumeroParcelas(int numeroParcelas) { this->numeroParcelas = numeroParcelas; }
+};
+
+class Tarefa {
+private:
+    Simbolo idTarefa;
+    Simbolo idLar;
+    Simbolo idPrestador;
+    std::string dataInicio;
+    int prazoEntrega;
+    Dinheiro valorPrestador;
+    int numParcelas;
+
+public:
+    Tarefa(Simbolo idTarefa, Simbolo idLar, Simbolo idPrestador, std::string dataInicio, int prazoEntrega, Dinheiro valorPrestador, int numParcelas)
+        : idTarefa(idTarefa), idLar(idLar), idPrestador(idPrestador), dataInicio(std::move(dataInicio)),
+          prazoEntrega(prazoEntrega), valorPrestador(valorPrestador), numParcelas(numParcelas) {}
+
+    Simbolo getIdTarefa() const { return idTarefa; }
+    Simbolo getIdLar() const { return idLar; }
+    Simbolo getIdPrestador() const { return idPrestador; }
+    std::string getDataInicio() const { return dataInicio; }
+    int getPrazoEntrega() const { return prazoEntrega; }
+    Dinheiro getValorPrestador() const { return valorPrestador; }
+    int getNumParcelas() const { return numParcelas; }
+
+    void setIdTarefa(Simbolo idTarefa) { this->idTarefa = idTarefa; }
+    void setIdLar(Simbolo idLar) { this->idLar = idLar; }
+    void setIdPrestador(Simbolo idPrestador) { this->idPrestador = idPrestador; }
+    void setDataInicio(const std::string& dataInicio) { this->dataInicio = dataInicio; }
+    void setPrazoEntrega(int prazoEntrega) { this->prazoEntrega = prazoEntrega; }
+    void setValorPrestador(Dinheiro valorPrestador) { this->valorPrestador = valorPrestador; }
+    void setNumParcelas(int numParcelas) { this->numParcelas = numParcelas; }
+};
+
+class Lar {
+private:
+    Simbolo idLar;
+    Simbolo id1;
+    Simbolo id2;
+    std::string rua;
+    int numero;
+    std::string complemento;
+
+public:
+    Lar(Simbolo idLar, Simbolo id1, Simbolo id2, std::string rua, int numero, std::string complemento)
+        : idLar(idLar), id1(id1), id2(id2), rua(std::move(rua)), numero(numero), complemento(std::move(complemento)) {}
+
+    Simbolo getIdLar() const { return idLar; }
+    Simbolo getId1() const { return id1; }
+    Simbolo getId2() const { return id2; }
+    std::string getRua() const { return rua; }
+    int getNumero() const { return numero; }
+    std::string getComplemento() const { return complemento; }
+
+    void setIdLar(Simbolo idLar) { this->idLar = idLar; }
+    void setId1(Simbolo id1) { this->id1 = id1; }
+    void setId2(Simbolo id2) { this->id2 = id2; }
+    void setRua(const std::string& rua) { this->rua = rua; }
+    void setNumero(int numero) { this->numero = numero; }
+    void setComplemento(const std::string& complemento) { this->complemento = complemento; }
+};
+
+class Festa {
+private:
+    Simbolo id;
+    Simbolo idCasamento;
+    std::string local;
+    std::string data;
+    std::string hora;
+    Dinheiro valorPago;
+    int numParcelas;
+    std::vector<Simbolo> convidados;
+
+public:
+    Festa(Simbolo id, Simbolo idCasamento, std::string local, std::string data, std::string hora, Dinheiro valorPago, int numParcelas, std::vector<Simbolo> convidados)
+        : id(id), idCasamento(idCasamento), local(std::move(local)), data(std::move(data)), hora(std::move(hora)), valorPago(valorPago), numParcelas(numParcelas), convidados(std::move(convidados)) {}
+
+    Simbolo getId() const { return id; }
+    Simbolo getIdCasamento() const { return idCasamento; }
+    std::string getLocal() const { return local; }
+    std::string getData() const { return data; }
+    std::string getHora() const { return hora; }
+    Dinheiro getValorPago() const { return valorPago; }
+    int getNumParcelas() const { return numParcelas; }
+    const std::vector<Simbolo>& getConvidados() const { return convidados; }
+
+    void setId(Simbolo id) { this->id = id; }
+    void setIdCasamento(Simbolo idCasamento) { this->idCasamento = idCasamento; }
+    void setLocal(const std::string& local) { this->local = local; }
+    void setData(const std::string& data) { this->data = data; }
+    void setHora(const std::string& hora) { this->hora = hora; }
+    void setValorPago(Dinheiro valorPago) { this->valorPago = valorPago; }
+    void setNumParcelas(int numParcelas) { this->numParcelas = numParcelas; }
+    void setConvidados(const std::vector<Simbolo>& convidados) { this->convidados = convidados; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Entidades.h"
+
+// Writes one report file through a single descriptor and a large in-memory
+// buffer. Rows are formatted straight into the buffer and reach the file in
+// big write() calls only when the buffer fills up or on fechar().
+class EscritorRelatorio {
+public:
+    // The buffer is flushed once it grows past this size
+    static constexpr size_t TAMANHO_BUFFER = 1 << 20;
+
+private:
+    int fd = -1;
+    std::string buffer;
+
+    void descarregar();
+
+public:
+    // Creates (or truncates) the file
+    explicit EscritorRelatorio(const std::string& caminho);
+
+    // Closes without flushing: a report abandoned by an input error must not
+    // write anything after the empty reports have been generated
+    ~EscritorRelatorio();
+
+    EscritorRelatorio(const EscritorRelatorio&) = delete;
+    EscritorRelatorio& operator=(const EscritorRelatorio&) = delete;
+
+    bool is_open() const { return fd >= 0; }
+
+    void escrever(std::string_view texto);
+    void escrever(char c);
+    void escreverInt(int valor);
+
+    // MM/YYYY, same as setw(2) << setfill('0') << mes << "/" << ano
+    void escreverMesAno(const YearMonth& ym);
+
+    // "R$ 1234,56", no thousands separator
+    void escreverMoeda(Dinheiro valor);
+
+    // Writes whatever is still buffered and closes the file
+    void fechar();
+};
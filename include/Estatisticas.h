@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "Dinheiro.h"
+#include "Entidades.h"
+#include "Registro.h"
+#include "ThreadPool.h"
+
+// One line of 2-estatisticas-prestadores.csv before sorting
+struct ReceitaPrestador {
+    Pessoa* pessoa;
+    Dinheiro valor;
+};
+
+// What every provider received, in getPessoas() order. PF and PJ are paid
+// through their tarefas, a Loja through its compras (preço × quantidade). A PF
+// that received nothing is left out; PJ and Loja are always listed.
+//
+// One pass over tarefas and one over compras, grouped by the registry's ID
+// index. Large inputs are split into blocks on the pool and the partial sums
+// are merged by provider partition, so no two workers touch the same total.
+std::vector<ReceitaPrestador> calcularReceitaPrestadores(const Registro& registro, ThreadPool& pool);
+
+// Order of 2-estatisticas-prestadores.csv: PF, then PJ (not Loja), then
+// Loja; within each kind by value (descending), then by name, then by
+// position. Rows are ordered on packed (kind, value, name rank) keys, with
+// a parallel radix sort for large inputs.
+void ordenarReceitaPrestadores(std::vector<ReceitaPrestador>& receitas, ThreadPool& pool);
+
+// One couple of 3-estatisticas-casais.csv, written once per input line
+// that named it
+struct LinhaCasal {
+    Simbolo nome1; // nome1 <= nome2, as in Casal
+    Simbolo nome2;
+    Dinheiro totalGasto;
+    int festasEmComum = 0;
+    std::uint64_t linhas = 0;
+};
+
+// The couples of 3-estatisticas-casais.csv, filled line by line in input
+// order. A couple is a pair of names in either order, as in Casal: its total
+// is the one of the last line naming it and its festas add up over all of
+// them. Memory grows with the distinct couples, not with the input lines.
+class EstatisticasCasais {
+private:
+    std::vector<LinhaCasal> casais;
+    std::unordered_map<std::uint64_t, std::uint32_t> porNomes; // Registro::chaveCasal of the names
+    std::uint64_t numLinhas = 0;
+
+public:
+    void adicionar(Simbolo nomeA, Simbolo nomeB, Dinheiro totalGasto, int festasEmComum);
+
+    std::uint64_t getNumLinhas() const { return numLinhas; }
+
+    // Visits the couples in report order: total (descending), then nome1,
+    // then nome2. The sort works on packed (total, name ranks, row) keys and
+    // spills to temporary run files past orcamentoBytes of keys (see
+    // OrdenacaoExterna.h); throws runtime_error when a run fails.
+    void visitarEmOrdem(size_t orcamentoBytes, const std::function<void(const LinhaCasal&)>& visitar) const;
+};
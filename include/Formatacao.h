@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Dinheiro.h"
+#include "Entidades.h"
+
+// Formatting of report cells into a caller-supplied buffer, without heap
+// allocation. Each function writes at most the matching TAMANHO_MAX_* bytes
+// starting at saida and returns the position just past the last one written
+// (no terminating '\0').
+
+// "R$ " + sign + 309 integer digits of the largest double + ",00"
+constexpr size_t TAMANHO_MAX_MOEDA = 320;
+
+// Two int fields and the '/'
+constexpr size_t TAMANHO_MAX_MES_ANO = 24;
+
+// "R$ 1234,56": the value rounded to two decimals exactly like printf("%.2f")
+// (half-to-even on the exact binary value, "-0,00" for small negatives), with
+// a decimal comma and no thousands separator
+char* formatarMoedaBr(char* saida, double valor);
+
+// Same text for an exact amount of cents
+char* formatarMoedaBr(char* saida, Dinheiro valor);
+
+// "MM/YYYY": the month padded to two digits with '0', as setw(2)/setfill('0')
+char* formatarMesAno(char* saida, const YearMonth& ym);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Opt-in tracing of the hot paths, turned on by --instrumentar or --trace.
+// A Trecho times a scope (a loader slice, a validation rule, a couple, a
+// report writer) and can carry the rows and bytes it handled; Registro
+// lookups and heap allocations are counted. Events are buffered per thread
+// and merged when a report is written. While it is off, a Trecho or a
+// counter costs one test of a global flag.
+
+extern bool instrumentacaoLigada;
+
+// Must be called before the worker threads start
+void ligarInstrumentacao();
+
+// Steady clock, in nanoseconds
+std::uint64_t instanteNs();
+
+void registrarTrecho(const char* nome, const char* categoria, std::uint64_t inicio, std::uint64_t itens,
+                     std::uint64_t bytes);
+void registrarBusca();
+
+inline void contarBusca() {
+    if (instrumentacaoLigada) {
+        registrarBusca();
+    }
+}
+
+// Times the enclosing scope. nome and categoria must live until the report
+// is written (string literals).
+class Trecho {
+private:
+    const char* nome;
+    const char* categoria;
+    std::uint64_t inicio = 0;
+    std::uint64_t itens = 0;
+    std::uint64_t bytes = 0;
+
+public:
+    Trecho(const char* nome, const char* categoria) : nome(nome), categoria(categoria) {
+        if (instrumentacaoLigada) {
+            inicio = instanteNs();
+        }
+    }
+
+    ~Trecho() {
+        if (instrumentacaoLigada) {
+            registrarTrecho(nome, categoria, inicio, itens, bytes);
+        }
+    }
+
+    Trecho(const Trecho&) = delete;
+    Trecho& operator=(const Trecho&) = delete;
+
+    void contarItens(std::uint64_t n) { itens += n; }
+    void contarBytes(std::uint64_t n) { bytes += n; }
+};
+
+// JSON summary: for every Trecho name its calls, total, p50, p99 and max
+// time, a log2 histogram of durations in microseconds and the rows and
+// bytes handled per second; then the lookup and allocation counters.
+// Throws runtime_error on I/O failure.
+void gravarResumoInstrumentacao(const std::string& caminho);
+
+// Chrome trace-event JSON (chrome://tracing, Perfetto): one complete event
+// per Trecho on its thread's track and the counters at the end. Throws
+// runtime_error on I/O failure.
+void gravarTraceInstrumentacao(const std::string& caminho);
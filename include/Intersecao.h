@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Number of values present in both a and b. Both lists must be sorted in
+// increasing order without repeated values. Uses AVX2 or SSE2 block
+// comparisons when the CPU has them (checked once, at the first call) and
+// binary searches when one list is much shorter than the other.
+size_t contarIntersecao(const std::uint32_t* a, size_t tamanhoA, const std::uint32_t* b, size_t tamanhoB);
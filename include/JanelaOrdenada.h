@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Bounded queue between the stages of a pipeline whose middle stage runs out
+// of order. The producer numbers each item with reservar(), workers hand the
+// results back with entregar() in any order and a single consumer takes them
+// with proximo() in numbering order. At most `capacidade` items are between
+// reservar() and proximo() at any time, so a slow consumer stalls the
+// producer instead of piling results up in memory.
+template <typename T>
+class JanelaOrdenada {
+private:
+    size_t capacidade;
+    std::mutex trava;
+    std::condition_variable mudou;
+    std::map<size_t, T> prontos; // Delivered, waiting for their turn
+    size_t reservados = 0;
+    size_t entregues = 0;
+    size_t consumidos = 0;
+    bool fechada = false;
+    bool cancelada = false;
+
+public:
+    explicit JanelaOrdenada(size_t capacidade) : capacidade(capacidade > 0 ? capacidade : 1) {}
+
+    JanelaOrdenada(const JanelaOrdenada&) = delete;
+    JanelaOrdenada& operator=(const JanelaOrdenada&) = delete;
+
+    // Number of the next item; waits while the window is full. None once
+    // the window was cancelled.
+    std::optional<size_t> reservar() {
+        std::unique_lock<std::mutex> lock(trava);
+        mudou.wait(lock, [this]() { return cancelada || reservados - consumidos < capacidade; });
+        if (cancelada) {
+            return std::nullopt;
+        }
+        return reservados++;
+    }
+
+    // Every reserved number must be delivered, even after a cancellation
+    void entregar(size_t numero, T item) {
+        std::lock_guard<std::mutex> lock(trava);
+        prontos.emplace(numero, std::move(item));
+        entregues++;
+        mudou.notify_all();
+    }
+
+    // The producer will not reserve more
+    void fechar() {
+        std::lock_guard<std::mutex> lock(trava);
+        fechada = true;
+        mudou.notify_all();
+    }
+
+    // Stops the pipeline: reservar() and proximo() return none from now on
+    void cancelar() {
+        std::lock_guard<std::mutex> lock(trava);
+        cancelada = true;
+        mudou.notify_all();
+    }
+
+    // The next item in numbering order; none when the window is closed and
+    // drained, or cancelled
+    std::optional<T> proximo() {
+        std::unique_lock<std::mutex> lock(trava);
+        mudou.wait(lock, [this]() {
+            return cancelada || prontos.count(consumidos) > 0 || (fechada && consumidos == reservados);
+        });
+        if (cancelada || prontos.count(consumidos) == 0) {
+            return std::nullopt;
+        }
+        auto no = prontos.extract(consumidos++);
+        mudou.notify_all();
+        return std::move(no.mapped());
+    }
+
+    // Waits until every reserved item was delivered, so no worker still
+    // refers to the window
+    void aguardarEntregas() {
+        std::unique_lock<std::mutex> lock(trava);
+        mudou.wait(lock, [this]() { return entregues == reservados; });
+    }
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Just enough JSON for the server protocol. A request is a flat object
+// whose values are strings, numbers, booleans or null; strings are decoded,
+// other values are kept as their literal text. Nested objects and arrays
+// are rejected.
+using ObjetoJson = std::unordered_map<std::string, std::string>;
+
+std::optional<ObjetoJson> lerObjetoJson(std::string_view texto);
+
+// Appends texto as a quoted JSON string
+void anexarTextoJson(std::string& destino, std::string_view texto);
+
+void anexarInteiroJson(std::string& destino, std::int64_t valor);
+
+// Shortest text that reads back as valor; NaN and infinities become null
+void anexarRealJson(std::string& destino, double valor);
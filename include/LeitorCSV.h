@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only memory mapping of a whole file. The mapping lives as long as
+// the object, so views handed out by conteudo() must not outlive it.
+class ArquivoMapeado {
+private:
+    const char* dados = nullptr;
+    size_t tamanho = 0;
+    bool aberto = false;
+
+public:
+    explicit ArquivoMapeado(const std::string& caminho);
+    ~ArquivoMapeado();
+
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+    bool is_open() const { return aberto; }
+    std::string_view conteudo() const { return std::string_view(dados, tamanho); }
+};
+
+// Walks a ';'-delimited buffer line by line, splitting each line in place
+// into views over the buffer. Empty lines are skipped.
+class LeitorCSV {
+private:
+    std::string_view resto;
+    std::vector<std::string_view> campos;
+
+public:
+    explicit LeitorCSV(std::string_view conteudo) : resto(conteudo) {}
+
+    // Moves to the next non-empty line; false at the end of the buffer
+    bool proximaLinha();
+
+    size_t numCampos() const { return campos.size(); }
+
+    // Field i of the current line; throws std::out_of_range when missing
+    std::string_view campo(size_t i) const { return campos.at(i); }
+};
+
+// Cuts a buffer into at most maxTrechos slices of whole lines, each about the
+// same size and no smaller than tamanhoMinimo bytes (except the last one)
+std::vector<std::string_view> dividirEmTrechos(std::string_view conteudo, size_t maxTrechos,
+                                               size_t tamanhoMinimo);
+
+// Splits a field on a delimiter; the pieces are views into the field
+std::vector<std::string_view> dividirCampo(std::string_view campo, char delimitador);
+
+// Same leading-whitespace and error behavior as stoi/stod: parsing stops at
+// the first character that is not part of the number, and std::invalid_argument
+// or std::out_of_range is thrown when nothing or too much was read
+int paraInt(std::string_view campo);
+
+// Brazilian decimals such as "1.234,56" or "15000,00": '.' groups thousands
+// and ',' separates the cents. Same whitespace and error behavior as paraInt.
+double paraDecimalBr(std::string_view campo);
+
+// The same fields as an exact number of cents; decimals past the second
+// round half away from zero
+std::int64_t paraCentavosBr(std::string_view campo);
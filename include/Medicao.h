@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Wall time since construction
+class Cronometro {
+private:
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+public:
+    double segundos() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+};
+
+// Timings of a run, collected with --tempos: the duration and throughput of
+// every phase, the planning latency of each couple and the peak resident
+// set size, written as one JSON object.
+class Medicao {
+private:
+    struct Fase {
+        std::string nome;
+        double segundos;
+        std::uint64_t itens; // Rows, couples or report lines handled
+        std::uint64_t bytes;
+    };
+
+    std::vector<Fase> fases;
+    std::vector<double> latencias; // Seconds, one per planned couple
+    std::mutex mutexLatencias;
+
+public:
+    void registrarFase(std::string nome, double segundos, std::uint64_t itens = 0, std::uint64_t bytes = 0);
+
+    // Safe to call from several planning workers at once
+    void registrarLatencias(const std::vector<double>& segundosPorCasal);
+
+    // The report; "-" writes it to stdout. Throws runtime_error on I/O failure.
+    void gravar(const std::string& caminho, size_t numThreads);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "Planejamento.h"
+
+// Bounded LRU of the plans of recently queried couples, for long-running
+// use. Entries are keyed by the sorted pair of CPFs, so a couple asked for
+// in either order is planned once. Plans are shared read-only; p1 and p2 are
+// in the order of the query that planned them. Safe to use from several
+// threads; two threads missing the same couple may both plan it.
+class MemoriaPlanos {
+private:
+    using Entrada = std::pair<std::uint64_t, std::shared_ptr<const PlanoCasal>>;
+
+    size_t capacidade;
+    std::list<Entrada> recentes; // Most recently used first
+    std::unordered_map<std::uint64_t, std::list<Entrada>::iterator> porChave;
+    std::mutex acesso;
+
+public:
+    explicit MemoriaPlanos(size_t capacidade);
+
+    MemoriaPlanos(const MemoriaPlanos&) = delete;
+    MemoriaPlanos& operator=(const MemoriaPlanos&) = delete;
+
+    // Order-independent key of two CPFs; none when either was never
+    // interned, in which case the couple cannot be registered
+    static std::optional<std::uint64_t> chave(const std::string& cpf1, const std::string& cpf2);
+
+    // The plan of the couple, from memory or planned now. Unregistered
+    // couples are planned every time and not kept.
+    std::shared_ptr<const PlanoCasal> planejar(const Registro& registro, const std::string& cpf1,
+                                               const std::string& cpf2);
+};
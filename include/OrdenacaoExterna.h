@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+// Sorts numItens records made by gerar(i), i in [0, numItens), and hands
+// them to emitir(const T&) in operator< order. At most orcamentoBytes of
+// records are held for sorting at a time: when they all fit they are sorted
+// in place, otherwise each sorted chunk is written as a run to a temporary
+// file and the runs are merged, each read back through its share of the
+// budget.
+// The run file is deleted on close. Throws runtime_error when a run cannot
+// be written (before anything was emitted) or read back (at any point).
+template <typename T, typename Gerar, typename Emitir>
+void ordenarComOrcamento(size_t numItens, Gerar gerar, Emitir emitir, size_t orcamentoBytes) {
+    static_assert(std::is_trivially_copyable_v<T>, "runs are written as raw bytes");
+
+    size_t porBloco = std::max<size_t>(orcamentoBytes / sizeof(T), 1);
+    std::vector<T> bloco;
+    bloco.reserve(std::min(numItens, porBloco));
+
+    if (numItens <= porBloco) {
+        for (size_t i = 0; i < numItens; i++) {
+            bloco.push_back(gerar(i));
+        }
+        std::sort(bloco.begin(), bloco.end());
+        for (const T& item : bloco) {
+            emitir(item);
+        }
+        return;
+    }
+
+    // All runs go to one temporary file, one after the other, so the
+    // number of runs is not limited by open descriptors
+    struct FecharArquivo {
+        void operator()(FILE* arquivo) const { fclose(arquivo); }
+    };
+    std::unique_ptr<FILE, FecharArquivo> arquivo(tmpfile());
+    if (!arquivo) {
+        throw std::runtime_error("cannot create a sort run file");
+    }
+    int fd = fileno(arquivo.get());
+
+    struct Run {
+        off_t inicio; // In records
+        off_t fim;
+    };
+    std::vector<Run> runs;
+
+    for (size_t inicio = 0; inicio < numItens; inicio += porBloco) {
+        size_t fim = std::min(numItens, inicio + porBloco);
+        bloco.clear();
+        for (size_t i = inicio; i < fim; i++) {
+            bloco.push_back(gerar(i));
+        }
+        std::sort(bloco.begin(), bloco.end());
+
+        size_t bytes = bloco.size() * sizeof(T);
+        if (pwrite(fd, bloco.data(), bytes, static_cast<off_t>(inicio * sizeof(T))) != static_cast<ssize_t>(bytes)) {
+            throw std::runtime_error("cannot write a sort run");
+        }
+        runs.push_back({static_cast<off_t>(inicio), static_cast<off_t>(fim)});
+    }
+    std::vector<T>().swap(bloco);
+
+    // Each run is read back through its own slice of the budget
+    struct Leitor {
+        int fd;
+        Run restante;
+        std::vector<T> buffer;
+        size_t posicao = 0;
+
+        bool carregar() {
+            size_t quantos = static_cast<size_t>(std::min<off_t>(restante.fim - restante.inicio, buffer.capacity()));
+            buffer.resize(quantos);
+            size_t bytes = quantos * sizeof(T);
+            if (pread(fd, buffer.data(), bytes, restante.inicio * static_cast<off_t>(sizeof(T)))
+                != static_cast<ssize_t>(bytes)) {
+                throw std::runtime_error("cannot read a sort run");
+            }
+            restante.inicio += static_cast<off_t>(quantos);
+            posicao = 0;
+            return quantos > 0;
+        }
+    };
+
+    size_t porLeitura = std::max<size_t>(porBloco / runs.size(), 1);
+    std::vector<Leitor> leitores(runs.size());
+    using Cabeca = std::pair<T, size_t>; // Smallest unread record of a run
+    auto maior = [](const Cabeca& a, const Cabeca& b) { return b.first < a.first; };
+    std::priority_queue<Cabeca, std::vector<Cabeca>, decltype(maior)> cabecas(maior);
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        leitores[r].fd = fd;
+        leitores[r].restante = runs[r];
+        leitores[r].buffer.reserve(porLeitura);
+        if (leitores[r].carregar()) {
+            cabecas.emplace(leitores[r].buffer[leitores[r].posicao++], r);
+        }
+    }
+
+    while (!cabecas.empty()) {
+        auto [item, r] = cabecas.top();
+        cabecas.pop();
+        emitir(item);
+
+        Leitor& leitor = leitores[r];
+        if (leitor.posicao < leitor.buffer.size() || leitor.carregar()) {
+            cabecas.emplace(leitor.buffer[leitor.posicao++], r);
+        }
+    }
+}
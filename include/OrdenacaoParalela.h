@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Below this many items the sorts run on the calling thread
+constexpr size_t MINIMO_ORDENACAO_PARALELA = 1 << 16;
+
+// Sorts by menor: contiguous blocks are sorted on the pool, then merged
+// pairwise, every merge of a round on its own worker. Not stable.
+template <typename T, typename Menor>
+void ordenarParalelo(std::vector<T>& itens, Menor menor, ThreadPool& pool) {
+    size_t numBlocos = pool.getNumThreads();
+    if (numBlocos < 2 || itens.size() < MINIMO_ORDENACAO_PARALELA) {
+        std::sort(itens.begin(), itens.end(), menor);
+        return;
+    }
+
+    std::vector<size_t> limites(numBlocos + 1);
+    for (size_t b = 0; b <= numBlocos; b++) {
+        limites[b] = itens.size() * b / numBlocos;
+    }
+    pool.paraCada(numBlocos, [&](size_t b) {
+        std::sort(itens.begin() + limites[b], itens.begin() + limites[b + 1], menor);
+    });
+
+    for (size_t passo = 1; passo < numBlocos; passo *= 2) {
+        size_t numFusoes = (numBlocos + 2 * passo - 1) / (2 * passo);
+        pool.paraCada(numFusoes, [&](size_t f) {
+            size_t inicio = 2 * passo * f;
+            size_t meio = std::min(numBlocos, inicio + passo);
+            size_t fim = std::min(numBlocos, inicio + 2 * passo);
+            std::inplace_merge(itens.begin() + limites[inicio], itens.begin() + limites[meio],
+                               itens.begin() + limites[fim], menor);
+        });
+    }
+}
+
+// Stable LSD radix sort on numDigitos 16-bit digits; digito(item, d) gives
+// digit d, 0 being the least significant. Each pass counts the digits of
+// contiguous blocks on the pool and scatters every block to its own
+// offsets, so the passes stay stable; a pass whose digit is the same for
+// every item is skipped.
+template <typename T, typename Digito>
+void ordenarRadix(std::vector<T>& itens, size_t numDigitos, Digito digito, ThreadPool& pool) {
+    constexpr size_t BALDES = 1 << 16;
+    size_t numBlocos = itens.size() < MINIMO_ORDENACAO_PARALELA ? 1 : std::max<size_t>(pool.getNumThreads(), 1);
+    std::vector<size_t> limites(numBlocos + 1);
+    for (size_t b = 0; b <= numBlocos; b++) {
+        limites[b] = itens.size() * b / numBlocos;
+    }
+
+    auto emBlocos = [&](auto f) {
+        if (numBlocos > 1) {
+            pool.paraCada(numBlocos, f);
+        } else {
+            f(0);
+        }
+    };
+
+    std::vector<T> auxiliar(itens.size());
+    std::vector<std::vector<size_t>> posicoes(numBlocos, std::vector<size_t>(BALDES));
+
+    for (size_t d = 0; d < numDigitos; d++) {
+        emBlocos([&](size_t b) {
+            std::vector<size_t>& contagem = posicoes[b];
+            std::fill(contagem.begin(), contagem.end(), 0);
+            for (size_t i = limites[b]; i < limites[b + 1]; i++) {
+                contagem[digito(itens[i], d)]++;
+            }
+        });
+
+        // Digit-major, block-minor prefix sums turn the counts into the
+        // first position of every (block, digit)
+        size_t posicao = 0;
+        bool constante = false;
+        for (size_t balde = 0; balde < BALDES; balde++) {
+            size_t doBalde = 0;
+            for (size_t b = 0; b < numBlocos; b++) {
+                size_t contagem = posicoes[b][balde];
+                posicoes[b][balde] = posicao;
+                posicao += contagem;
+                doBalde += contagem;
+            }
+            if (doBalde == itens.size()) {
+                constante = true;
+                break;
+            }
+        }
+        if (constante) {
+            continue;
+        }
+
+        emBlocos([&](size_t b) {
+            std::vector<size_t>& proxima = posicoes[b];
+            for (size_t i = limites[b]; i < limites[b + 1]; i++) {
+                auxiliar[proxima[digito(itens[i], d)]++] = itens[i];
+            }
+        });
+        itens.swap(auxiliar);
+    }
+}
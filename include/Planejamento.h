@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "CachePlanos.h"
+#include "Entidades.h"
+#include "Registro.h"
+
+// Everything process_files needs to report one CPF pair
+struct PlanoCasal {
+    // Null when the CPF is not registered; the pair is then an input error
+    const PessoaFisica* p1 = nullptr;
+    const PessoaFisica* p2 = nullptr;
+
+    std::vector<YearMonth> timeline;
+    std::vector<Dinheiro> saldos;
+    Dinheiro totalGasto;
+    int festasEmComum = 0;
+
+    // Only filled when planning against a cache
+    ChavePlano chave;
+    bool doCache = false; // Timeline and balances came from the cache
+};
+
+// Collects the couple's tarefas, festas and compras, simulates the savings
+// account month by month and counts the parties both attended. Only reads
+// the registry, so several couples can be planned at the same time.
+// With a cache, a couple whose inputs did not change since the cached run
+// takes its timeline and balances from it instead of simulating again.
+PlanoCasal planejarCasal(const Registro& registro, const std::string& cpf1, const std::string& cpf2,
+                         const CachePlanos* cache = nullptr);
+
+// Plans several couples; their savings accounts are simulated together, in
+// SIMD lanes where the CPU allows (see Poupanca.h). segundosPorCasal, when
+// given, receives the time spent on each couple, with the joint simulation
+// split evenly among the couples it ran.
+std::vector<PlanoCasal> planejarCasais(const Registro& registro,
+                                       const std::vector<std::pair<std::string_view, std::string_view>>& pares,
+                                       const CachePlanos* cache = nullptr,
+                                       std::vector<double>* segundosPorCasal = nullptr);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Dinheiro.h"
+
+// Savings account of one couple over its timeline. Every month the balance
+// earns 0.5% interest (rounded to the cent, ties away from zero), receives
+// the salaries (plus decimoTerceiro in December) and pays the monthly costs
+// and the expenses due that month.
+struct ContaPoupanca {
+    Dinheiro saldoInicial;
+    Dinheiro salario;        // Both salaries
+    Dinheiro decimoTerceiro; // Extra paid in December
+    Dinheiro gastosMensais;
+    int primeiroMes = 0;     // Absolute month (YearMonth) of the first balance
+    size_t numMeses = 0;
+    // Change in the expenses due from the previous month, numMeses entries
+    const Dinheiro* variacao = nullptr;
+    // Receives the numMeses balances
+    Dinheiro* saldos = nullptr;
+};
+
+// Simulates every account. Couples of similar length are run side by side,
+// one per AVX-512 or AVX2 lane when the CPU has them (checked once, at the
+// first call); the balances are the same, to the cent, as the scalar loop's.
+void simularPoupancas(const ContaPoupanca* contas, size_t numContas);
+
+// The scalar loop, one account after the other
+void simularPoupancasEscalar(const ContaPoupanca* contas, size_t numContas);
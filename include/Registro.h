@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Entidades.h"
+#include "Tabelas.h"
+
+// Hashed index over the loaded entities, built once after loading.
+// Lookups return the first row with the given key, like the old linear
+// findXById scans did. Secondary indexes hold row positions in file order.
+// All keys are interned Simbolos, so a lookup hashes and compares integers.
+// The fields the planning and provider passes scan are also copied into
+// columnar tables, row for row.
+// The entity vectors must not be modified while the registry is alive.
+class Registro {
+private:
+    const std::vector<Pessoa*>& pessoas;
+    const std::vector<Lar>& lares;
+    const std::vector<Tarefa>& tarefas;
+    const std::vector<Casamento>& casamentos;
+    const std::vector<Festa>& festas;
+    const std::vector<Compra>& compras;
+
+    TabelaTarefas tabelaTarefas;
+    TabelaCompras tabelaCompras;
+    TabelaFestas tabelaFestas;
+
+    std::unordered_map<Simbolo, size_t> pessoaPorId;
+    std::unordered_map<Simbolo, size_t> pessoaPorCpf;
+    std::unordered_map<Simbolo, size_t> pessoaPorCnpj;
+    std::unordered_map<Simbolo, size_t> larPorId;
+    std::unordered_map<Simbolo, size_t> tarefaPorId;
+    std::unordered_map<Simbolo, size_t> casamentoPorId;
+    std::unordered_map<Simbolo, size_t> festaPorId;
+    std::unordered_map<Simbolo, size_t> compraPorId;
+
+    std::unordered_map<Simbolo, std::vector<size_t>> tarefasPorLar;
+    std::unordered_map<Simbolo, std::vector<size_t>> comprasPorTarefa;
+    std::unordered_map<Simbolo, std::vector<size_t>> festasPorCasamento;
+    std::unordered_map<std::uint64_t, std::vector<size_t>> laresPorCasal;
+    std::unordered_map<std::uint64_t, std::vector<size_t>> casamentosPorCasal;
+
+    // Guest name -> positions of the festas listing that guest, sorted and
+    // without repeats, ready for contarIntersecao
+    std::unordered_map<Simbolo, std::vector<std::uint32_t>> festasPorConvidado;
+
+public:
+    Registro(const std::vector<Pessoa*>& pessoas, const std::vector<Lar>& lares,
+             const std::vector<Tarefa>& tarefas, const std::vector<Casamento>& casamentos,
+             const std::vector<Festa>& festas, const std::vector<Compra>& compras);
+
+    Registro(const Registro&) = delete;
+    Registro& operator=(const Registro&) = delete;
+
+    // Order-independent key for the couple formed by two Pessoa IDs
+    static std::uint64_t chaveCasal(Simbolo id1, Simbolo id2);
+
+    // Returned by the findIndice* lookups when the key is not registered
+    static constexpr size_t NAO_ENCONTRADO = static_cast<size_t>(-1);
+
+    Pessoa* findPessoaById(Simbolo id) const;
+    // Position in getPessoas() of the Pessoa with this ID, or NAO_ENCONTRADO
+    size_t findIndicePessoaById(Simbolo id) const;
+    PessoaFisica* findPessoaByCpf(Simbolo cpf) const;
+    Pessoa* findPessoaByCnpj(Simbolo cnpj) const;
+    const Lar* findLarById(Simbolo idLar) const;
+    const Tarefa* findTarefaById(Simbolo idTarefa) const;
+    // Position in getTarefas() of the Tarefa with this ID, or NAO_ENCONTRADO
+    size_t findIndiceTarefaById(Simbolo idTarefa) const;
+    const Casamento* findCasamentoById(Simbolo idCasamento) const;
+    const Festa* findFestaById(Simbolo id) const;
+    const Compra* findCompraById(Simbolo id) const;
+
+    // Row positions (file order) of the tarefas whose idLar is the given one
+    const std::vector<size_t>& getTarefasDoLar(Simbolo idLar) const;
+    // Row positions (file order) of the compras whose idTarefa is the given one
+    const std::vector<size_t>& getComprasDaTarefa(Simbolo idTarefa) const;
+    // Row positions (file order) of the festas whose idCasamento is the given one
+    const std::vector<size_t>& getFestasDoCasamento(Simbolo idCasamento) const;
+    // Row positions (file order) of the lares / casamentos owned by the couple
+    const std::vector<size_t>& getLaresDoCasal(Simbolo id1, Simbolo id2) const;
+    const std::vector<size_t>& getCasamentosDoCasal(Simbolo id1, Simbolo id2) const;
+
+    // Positions (file order) of the festas whose guest list has this name
+    const std::vector<std::uint32_t>& getFestasDoConvidado(Simbolo nome) const;
+
+    const std::vector<Pessoa*>& getPessoas() const { return pessoas; }
+    const std::vector<Lar>& getLares() const { return lares; }
+    const std::vector<Tarefa>& getTarefas() const { return tarefas; }
+    const std::vector<Casamento>& getCasamentos() const { return casamentos; }
+    const std::vector<Festa>& getFestas() const { return festas; }
+    const std::vector<Compra>& getCompras() const { return compras; }
+
+    const TabelaTarefas& getTabelaTarefas() const { return tabelaTarefas; }
+    const TabelaCompras& getTabelaCompras() const { return tabelaCompras; }
+    const TabelaFestas& getTabelaFestas() const { return tabelaFestas; }
+};
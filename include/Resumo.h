@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// 64-bit non-cryptographic digest of a byte range (MurmurHash64A mixing,
+// eight bytes per step). Used to tell whether a file's content changed.
+std::uint64_t resumo64(std::string_view dados, std::uint64_t semente = 0);
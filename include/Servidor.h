@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Estatisticas.h"
+#include "MemoriaPlanos.h"
+#include "Registro.h"
+
+// Long-running mode: the dataset is loaded, indexed and validated once, and
+// planning and statistics queries are answered over a Unix stream socket.
+// Each line a client sends is one JSON request and gets one JSON line back:
+//
+//   {"op":"planejamento","cpf1":"...","cpf2":"..."}
+//       names, months ("MM/YYYY") and balances of the couple
+//   {"op":"casal","cpf1":"...","cpf2":"..."}
+//       total expenses and shared parties of the couple
+//   {"op":"prestadores"[,"limite":N]}
+//       provider revenue in report order
+//
+// Money is sent as integer cents. Failures answer {"ok":false,"erro":"..."}.
+// Every connection is served by its own thread; queries only read the
+// registry, so they run concurrently. Recently asked couples are answered
+// from a plan memory.
+class Servidor {
+public:
+    // Couples whose plans are kept between queries
+    static constexpr size_t CAPACIDADE_MEMORIA = 1 << 14;
+
+private:
+    const Registro& registro;
+    std::vector<ReceitaPrestador> prestadores;
+    mutable MemoriaPlanos memoria;
+
+    std::string responderCasal(const std::string& cpf1, const std::string& cpf2, bool comSaldos) const;
+    std::string responderPrestadores(size_t limite) const;
+    void atender(int conexao) const;
+
+public:
+    // prestadores already in report order
+    Servidor(const Registro& registro, std::vector<ReceitaPrestador> prestadores);
+
+    // Answer to one request line (without the trailing newline)
+    std::string responder(std::string_view requisicao) const;
+
+    // Serves caminhoSocket until SIGINT or SIGTERM. False if the socket
+    // cannot be created.
+    bool executar(const std::string& caminhoSocket) const;
+};
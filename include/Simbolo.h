@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Handle of an interned string: an ID, CPF, CNPJ or person/guest name. Equal
+// texts always get the same handle, so comparing or hashing two Simbolos is
+// a single integer operation. Handles are dense: the n-th distinct text
+// interned in the process gets n - 1.
+class Simbolo {
+public:
+    static constexpr std::uint32_t NENHUM = UINT32_MAX;
+
+private:
+    std::uint32_t handle = NENHUM;
+
+public:
+    constexpr Simbolo() = default;
+    constexpr explicit Simbolo(std::uint32_t handle) : handle(handle) {}
+
+    // Interns texto in the process-wide table; safe to call from several
+    // threads at once
+    static Simbolo de(std::string_view texto);
+
+    // The Simbolo of texto if it was ever interned, otherwise an invalid one
+    static Simbolo buscar(std::string_view texto);
+
+    // Number of distinct texts interned so far
+    static std::uint32_t totalInternados();
+
+    bool valido() const { return handle != NENHUM; }
+    std::uint32_t getHandle() const { return handle; }
+
+    // The interned text; empty for an invalid Simbolo
+    const std::string& texto() const;
+
+    bool operator==(const Simbolo&) const = default;
+};
+
+template <>
+struct std::hash<Simbolo> {
+    size_t operator()(Simbolo simbolo) const noexcept { return simbolo.getHandle(); }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CadastroPessoas.h"
+#include "Entidades.h"
+#include "LeitorCSV.h"
+#include "Validacao.h"
+
+// Identity of a source CSV at the time its section was written
+struct FonteSnapshot {
+    std::string nome;          // File name inside the input folder
+    std::uint64_t tamanho;
+    std::int64_t modificacao;  // Last write time, in filesystem clock ticks
+    std::uint64_t resumo;      // resumo64 of the content
+};
+
+// Binary copy of the parsed input CSVs, kept in the input folder. There is
+// one section per source file, tagged with that file's size, mtime and
+// content digest, so a run takes the sections of unchanged files and parses
+// only the others. A section holds its own table of interned texts followed
+// by the rows, with money in cents and text length-prefixed.
+//
+// The snapshot is only written after a fully valid run, so it also keeps
+// the messages each validation rule printed then.
+//
+// Layout: the common binary header (see Binario.h), then the body: section
+// table, validation messages and the section contents.
+class Snapshot {
+public:
+    static constexpr const char* NOME_ARQUIVO = "dados.snapshot";
+    static constexpr std::uint32_t VERSAO = 2;
+
+private:
+    struct Secao {
+        FonteSnapshot fonte;
+        std::string_view conteudo;
+    };
+
+    ArquivoMapeado arquivo;
+    std::vector<Secao> secoes;
+    std::vector<std::vector<std::string>> mensagensPorRegra;
+
+    // Section of this CSV if the file did not change since it was written
+    const Secao* secaoAtual(const std::string& caminhoFonte) const;
+
+public:
+    // Maps and checks the file; a missing, foreign, older-version or
+    // damaged snapshot is left without sections, so every CSV is parsed
+    explicit Snapshot(const std::string& caminho);
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    size_t numSecoes() const { return secoes.size(); }
+
+    // Fill destino from the section of the given CSV when that file is
+    // unchanged; false (destino untouched) when it must be parsed instead
+    bool carregar(const std::string& caminhoFonte, CadastroPessoas& destino) const;
+    bool carregar(const std::string& caminhoFonte, std::vector<Festa>& destino) const;
+    bool carregar(const std::string& caminhoFonte, std::vector<Casamento>& destino) const;
+    bool carregar(const std::string& caminhoFonte, std::vector<Lar>& destino) const;
+    bool carregar(const std::string& caminhoFonte, std::vector<Tarefa>& destino) const;
+    bool carregar(const std::string& caminhoFonte, std::vector<Compra>& destino) const;
+
+    // Validation history for a run whose files in arquivosInalterados
+    // (ARQUIVO_* bits) were all taken from this snapshot
+    HistoricoValidacao historico(std::uint8_t arquivosInalterados) const;
+};
+
+// Writes the snapshot of the loaded, validated data to
+// pasta/Snapshot::NOME_ARQUIVO, with a section for each of the six CSVs
+// present in the folder. Throws runtime_error on I/O failure.
+void gravarSnapshot(const std::string& pasta, const CadastroPessoas& pessoas, const std::vector<Festa>& festas,
+                    const std::vector<Casamento>& casamentos, const std::vector<Lar>& lares,
+                    const std::vector<Tarefa>& tarefas, const std::vector<Compra>& compras,
+                    const ResultadoValidacao& validacao);
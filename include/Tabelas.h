@@ -0,0 +1,50 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "Dinheiro.h"
+#include "Entidades.h"
+#include "Simbolo.h"
+
+// Column-wise copies of the fields the planning and provider passes read,
+// one contiguous array per field and one row per entity (same positions as
+// the entity vectors). Dates are stored already parsed, as absolute months.
+
+// Stored instead of the month when the date cannot be parsed; the pass that
+// reaches such a row parses the original text again to raise the error
+constexpr std::int32_t MES_INVALIDO = INT32_MIN;
+
+struct TabelaTarefas {
+    std::vector<Simbolo> idTarefa;
+    std::vector<Simbolo> idLar;
+    std::vector<Simbolo> idPrestador;
+    std::vector<std::int32_t> mesInicio;
+    std::vector<Dinheiro> valorPrestador;
+    std::vector<std::int32_t> numParcelas;
+
+    explicit TabelaTarefas(const std::vector<Tarefa>& tarefas);
+    size_t size() const { return idTarefa.size(); }
+};
+
+struct TabelaCompras {
+    std::vector<Simbolo> idTarefa;
+    std::vector<Simbolo> idLoja;
+    std::vector<std::int32_t> qtdeProduto;
+    std::vector<Dinheiro> precoUnitario;
+    std::vector<std::int32_t> numeroParcelas;
+
+    explicit TabelaCompras(const std::vector<Compra>& compras);
+    size_t size() const { return idTarefa.size(); }
+};
+
+struct TabelaFestas {
+    std::vector<Simbolo> idCasamento;
+    std::vector<std::int32_t> mesData;
+    std::vector<Dinheiro> valorPago;
+    std::vector<std::int32_t> numParcelas;
+
+    explicit TabelaFestas(const std::vector<Festa>& festas);
+    size_t size() const { return idCasamento.size(); }
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads fed from a shared FIFO queue. Tasks must not
+// block waiting on other tasks of the same pool.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> fila;
+    std::mutex trava;
+    std::condition_variable temTarefa;
+    bool parando = false;
+
+    void executar();
+
+public:
+    // numThreads == 0 uses one worker per hardware thread
+    explicit ThreadPool(size_t numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getNumThreads() const { return workers.size(); }
+
+    // Queues f and returns a future for its result; exceptions thrown by f
+    // are rethrown by future::get()
+    template <typename F>
+    auto submeter(F f) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto tarefa = std::make_shared<std::packaged_task<R()>>(std::move(f));
+        std::future<R> resultado = tarefa->get_future();
+        {
+            std::lock_guard<std::mutex> lock(trava);
+            fila.emplace([tarefa]() { (*tarefa)(); });
+        }
+        temTarefa.notify_one();
+        return resultado;
+    }
+
+    // Runs f(i) for every i in [0, numItens) on all workers and waits for them.
+    // Each worker starts with a contiguous share of the indices, takes work from
+    // the front of its own share and, once it is empty, steals from the back of
+    // the other shares. The first exception thrown by f is rethrown here.
+    template <typename F>
+    void paraCada(size_t numItens, F f) {
+        struct Fatia {
+            std::mutex trava;
+            size_t inicio = 0;
+            size_t fim = 0;
+        };
+
+        size_t numFatias = std::min(workers.size(), numItens);
+        if (numFatias == 0) {
+            return;
+        }
+
+        std::vector<std::unique_ptr<Fatia>> fatias;
+        for (size_t w = 0; w < numFatias; w++) {
+            fatias.push_back(std::make_unique<Fatia>());
+            fatias[w]->inicio = numItens * w / numFatias;
+            fatias[w]->fim = numItens * (w + 1) / numFatias;
+        }
+
+        auto trabalhar = [&fatias, &f, numFatias](size_t w) {
+            while (true) {
+                size_t item = 0;
+                bool achou = false;
+                {
+                    Fatia& propria = *fatias[w];
+                    std::lock_guard<std::mutex> lock(propria.trava);
+                    if (propria.inicio < propria.fim) {
+                        item = propria.inicio++;
+                        achou = true;
+                    }
+                }
+                for (size_t k = 1; !achou && k < numFatias; k++) {
+                    Fatia& vitima = *fatias[(w + k) % numFatias];
+                    std::lock_guard<std::mutex> lock(vitima.trava);
+                    if (vitima.inicio < vitima.fim) {
+                        item = --vitima.fim;
+                        achou = true;
+                    }
+                }
+                if (!achou) {
+                    return;
+                }
+                f(item);
+            }
+        };
+
+        std::vector<std::future<void>> pendentes;
+        for (size_t w = 0; w < numFatias; w++) {
+            pendentes.push_back(submeter([&trabalhar, w]() { trabalhar(w); }));
+        }
+        for (std::future<void>& pendente : pendentes) {
+            pendente.wait();
+        }
+        for (std::future<void>& pendente : pendentes) {
+            pendente.get();
+        }
+    }
+};
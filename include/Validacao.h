@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Registro.h"
+
+// Input files, as bits of a mask
+constexpr std::uint8_t ARQUIVO_PESSOAS = 1 << 0;
+constexpr std::uint8_t ARQUIVO_FESTAS = 1 << 1;
+constexpr std::uint8_t ARQUIVO_CASAMENTOS = 1 << 2;
+constexpr std::uint8_t ARQUIVO_LARES = 1 << 3;
+constexpr std::uint8_t ARQUIVO_TAREFAS = 1 << 4;
+constexpr std::uint8_t ARQUIVO_COMPRAS = 1 << 5;
+
+struct ResultadoValidacao {
+    // Messages in the order they must be printed; when the data is invalid
+    // the last one describes the error that stopped the validation
+    std::vector<std::string> mensagens;
+    bool valido = true;
+
+    // The same messages split by rule, in validation order; rules after
+    // the one that failed have no entry
+    std::vector<std::vector<std::string>> mensagensPorRegra;
+};
+
+// What the last fully valid run left behind: which input files still have
+// the same rows, and the messages every rule printed then
+struct HistoricoValidacao {
+    std::uint8_t arquivosInalterados = 0;
+    std::vector<std::vector<std::string>> mensagensPorRegra;
+};
+
+// Runs every duplicate-ID, CPF/CNPJ and foreign-key rule with hashed passes
+// over each entity list. Rules run in a fixed order and stop at the first
+// error, so the reported error is the same one the per-rule scans found.
+// With a history, a rule that only reads unchanged files is known to pass
+// and just repeats its old messages.
+ResultadoValidacao validarDados(const Registro& registro, const HistoricoValidacao* historico = nullptr);
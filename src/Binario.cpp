@@ -0,0 +1,69 @@
+#include "Binario.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "Resumo.h"
+
+using namespace std;
+namespace fs = filesystem;
+
+namespace {
+
+constexpr uint32_t MARCA_ORDEM = 0x01020304;
+constexpr size_t TAMANHO_MAGICO = 8;
+
+} // namespace
+
+optional<string_view> abrirCorpoBinario(string_view arquivo, string_view magico, uint32_t versao) {
+    try {
+        LeitorBinario cabecalho(arquivo);
+        if (cabecalho.bytes(TAMANHO_MAGICO) != magico.substr(0, TAMANHO_MAGICO)
+            || cabecalho.numero<uint32_t>() != versao
+            || cabecalho.numero<uint32_t>() != MARCA_ORDEM) {
+            return nullopt;
+        }
+        uint64_t tamanhoCorpo = cabecalho.numero<uint64_t>();
+        uint64_t resumoCorpo = cabecalho.numero<uint64_t>();
+
+        string_view corpo = cabecalho.bytes(arquivo.size() - (TAMANHO_MAGICO + 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t)));
+        if (corpo.size() != tamanhoCorpo || resumo64(corpo) != resumoCorpo) {
+            return nullopt;
+        }
+        return corpo;
+    } catch (const DadosBinariosInvalidos&) {
+        return nullopt;
+    }
+}
+
+void gravarArquivoBinario(const string& caminho, string_view magico, uint32_t versao, string_view corpo) {
+    string cabecalho(magico.substr(0, TAMANHO_MAGICO));
+    cabecalho.resize(TAMANHO_MAGICO, '\0');
+    anexarNumero(cabecalho, versao);
+    anexarNumero(cabecalho, MARCA_ORDEM);
+    anexarNumero(cabecalho, static_cast<uint64_t>(corpo.size()));
+    anexarNumero(cabecalho, resumo64(corpo));
+
+    fs::path destino(caminho);
+    fs::path temporario = destino;
+    temporario += ".tmp";
+    {
+        ofstream saida(temporario, ios::binary | ios::trunc);
+        saida.write(cabecalho.data(), static_cast<streamsize>(cabecalho.size()));
+        saida.write(corpo.data(), static_cast<streamsize>(corpo.size()));
+        if (!saida.flush()) {
+            saida.close();
+            error_code ignorado;
+            fs::remove(temporario, ignorado);
+            throw runtime_error("Erro de I/O");
+        }
+    }
+
+    error_code erro;
+    fs::rename(temporario, destino, erro);
+    if (erro) {
+        fs::remove(temporario, erro);
+        throw runtime_error("Erro de I/O");
+    }
+}
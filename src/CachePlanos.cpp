@@ -0,0 +1,87 @@
+#include "CachePlanos.h"
+
+#include <optional>
+
+#include "Binario.h"
+
+using namespace std;
+
+namespace {
+
+constexpr char MAGICO[8] = {'C', 'A', 'S', 'A', 'M', 'P', 'L', 'N'};
+
+} // namespace
+
+// Body: entry count, then per entry the key, the first month (absolute),
+// the number of months and one balance in cents per month
+CachePlanos::CachePlanos(const string& caminho) : arquivo(caminho) {
+    if (!arquivo.is_open()) {
+        return;
+    }
+    optional<string_view> corpo = abrirCorpoBinario(arquivo.conteudo(), string_view(MAGICO, sizeof(MAGICO)), VERSAO);
+    if (!corpo) {
+        return;
+    }
+
+    try {
+        LeitorBinario leitor(*corpo);
+        uint32_t numEntradas = leitor.numero<uint32_t>();
+        entradas.reserve(numEntradas);
+        for (uint32_t i = 0; i < numEntradas; i++) {
+            ChavePlano chave;
+            chave.a = leitor.numero<uint64_t>();
+            chave.b = leitor.numero<uint64_t>();
+            string_view cabecalho = leitor.bytes(sizeof(int32_t) + sizeof(uint32_t));
+            uint32_t numMeses;
+            memcpy(&numMeses, cabecalho.data() + sizeof(int32_t), sizeof(uint32_t));
+            string_view saldos = leitor.bytes(size_t(numMeses) * sizeof(int64_t));
+            entradas.emplace(chave, string_view(cabecalho.data(), cabecalho.size() + saldos.size()));
+        }
+    } catch (const DadosBinariosInvalidos&) {
+        entradas.clear();
+    }
+}
+
+bool CachePlanos::buscar(ChavePlano chave, vector<YearMonth>& timeline, vector<Dinheiro>& saldos) const {
+    auto it = entradas.find(chave);
+    if (it == entradas.end()) {
+        return false;
+    }
+
+    LeitorBinario leitor(it->second);
+    int32_t primeiroMes = leitor.numero<int32_t>();
+    uint32_t numMeses = leitor.numero<uint32_t>();
+
+    timeline.clear();
+    saldos.clear();
+    timeline.reserve(numMeses);
+    saldos.reserve(numMeses);
+    for (uint32_t m = 0; m < numMeses; m++) {
+        timeline.push_back(YearMonth::fromAbsoluteMonth(primeiroMes + static_cast<int32_t>(m)));
+        saldos.push_back(Dinheiro::deCentavos(leitor.numero<int64_t>()));
+    }
+    return true;
+}
+
+void GravadorCachePlanos::adicionar(ChavePlano chave, const vector<YearMonth>& timeline, const vector<Dinheiro>& saldos) {
+    if (!vistas.insert(chave).second) {
+        return;
+    }
+
+    anexarNumero(corpo, chave.a);
+    anexarNumero(corpo, chave.b);
+    anexarNumero(corpo, static_cast<int32_t>(timeline.empty() ? 0 : timeline.front().toAbsoluteMonth()));
+    anexarNumero(corpo, static_cast<uint32_t>(saldos.size()));
+    for (Dinheiro saldo : saldos) {
+        anexarNumero(corpo, saldo.getCentavos());
+    }
+    numEntradas++;
+}
+
+void GravadorCachePlanos::gravar(const string& caminho) const {
+    string arquivo;
+    arquivo.reserve(sizeof(uint32_t) + corpo.size());
+    anexarNumero(arquivo, numEntradas);
+    arquivo.append(corpo);
+    gravarArquivoBinario(caminho, string_view(MAGICO, sizeof(MAGICO)), CachePlanos::VERSAO, arquivo);
+}
@@ -0,0 +1,94 @@
+#include "CadastroPessoas.h"
+
+#include <iterator>
+
+using namespace std;
+
+namespace {
+
+template <typename T>
+void moverPara(vector<T>& destino, vector<T>& origem) {
+    destino.insert(destino.end(), make_move_iterator(origem.begin()), make_move_iterator(origem.end()));
+    origem.clear();
+}
+
+} // namespace
+
+void CadastroPessoas::adicionar(PessoaFisica&& pessoa) {
+    ordem.push_back({TipoPessoa::Fisica, static_cast<uint32_t>(fisicas.size())});
+    fisicas.push_back(move(pessoa));
+}
+
+void CadastroPessoas::adicionar(PessoaJuridica&& pessoa) {
+    ordem.push_back({TipoPessoa::Juridica, static_cast<uint32_t>(juridicas.size())});
+    juridicas.push_back(move(pessoa));
+}
+
+void CadastroPessoas::adicionar(Loja&& pessoa) {
+    ordem.push_back({TipoPessoa::Loja, static_cast<uint32_t>(lojas.size())});
+    lojas.push_back(move(pessoa));
+}
+
+void CadastroPessoas::anexar(vector<CadastroPessoas>& partes) {
+    size_t totalFisicas = fisicas.size();
+    size_t totalJuridicas = juridicas.size();
+    size_t totalLojas = lojas.size();
+    size_t totalOrdem = ordem.size();
+    for (const CadastroPessoas& parte : partes) {
+        totalFisicas += parte.fisicas.size();
+        totalJuridicas += parte.juridicas.size();
+        totalLojas += parte.lojas.size();
+        totalOrdem += parte.ordem.size();
+    }
+    fisicas.reserve(totalFisicas);
+    juridicas.reserve(totalJuridicas);
+    lojas.reserve(totalLojas);
+    ordem.reserve(totalOrdem);
+
+    for (CadastroPessoas& parte : partes) {
+        // Positions in the part are shifted past the rows already here
+        uint32_t baseFisicas = static_cast<uint32_t>(fisicas.size());
+        uint32_t baseJuridicas = static_cast<uint32_t>(juridicas.size());
+        uint32_t baseLojas = static_cast<uint32_t>(lojas.size());
+        for (Referencia referencia : parte.ordem) {
+            switch (referencia.tipo) {
+            case TipoPessoa::Fisica:
+                referencia.posicao += baseFisicas;
+                break;
+            case TipoPessoa::Juridica:
+                referencia.posicao += baseJuridicas;
+                break;
+            case TipoPessoa::Loja:
+                referencia.posicao += baseLojas;
+                break;
+            }
+            ordem.push_back(referencia);
+        }
+        moverPara(fisicas, parte.fisicas);
+        moverPara(juridicas, parte.juridicas);
+        moverPara(lojas, parte.lojas);
+        parte.ordem.clear();
+    }
+
+    indexar();
+}
+
+Pessoa* CadastroPessoas::get(Referencia referencia) {
+    switch (referencia.tipo) {
+    case TipoPessoa::Fisica:
+        return &fisicas[referencia.posicao];
+    case TipoPessoa::Juridica:
+        return &juridicas[referencia.posicao];
+    case TipoPessoa::Loja:
+        return &lojas[referencia.posicao];
+    }
+    return nullptr;
+}
+
+void CadastroPessoas::indexar() {
+    pessoas.clear();
+    pessoas.reserve(ordem.size());
+    for (Referencia referencia : ordem) {
+        pessoas.push_back(get(referencia));
+    }
+}
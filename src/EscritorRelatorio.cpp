@@ -0,0 +1,91 @@
+#include "EscritorRelatorio.h"
+
+#include <cerrno>
+#include <charconv>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Formatacao.h"
+
+using namespace std;
+
+EscritorRelatorio::EscritorRelatorio(const string& caminho) {
+    fd = open(caminho.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        buffer.reserve(TAMANHO_BUFFER);
+    }
+}
+
+EscritorRelatorio::~EscritorRelatorio() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void EscritorRelatorio::descarregar() {
+    const char* dados = buffer.data();
+    size_t restante = buffer.size();
+    while (restante > 0) {
+        ssize_t escrito = write(fd, dados, restante);
+        if (escrito < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break; // Same as an ofstream: a failed write is dropped silently
+        }
+        dados += escrito;
+        restante -= static_cast<size_t>(escrito);
+    }
+    buffer.clear();
+}
+
+void EscritorRelatorio::escrever(string_view texto) {
+    if (fd < 0) {
+        return;
+    }
+    if (buffer.size() + texto.size() > TAMANHO_BUFFER) {
+        descarregar();
+    }
+    if (texto.size() >= TAMANHO_BUFFER) {
+        buffer = texto;
+        descarregar();
+        return;
+    }
+    buffer.append(texto);
+}
+
+void EscritorRelatorio::escrever(char c) {
+    if (fd < 0) {
+        return;
+    }
+    buffer.push_back(c);
+    if (buffer.size() >= TAMANHO_BUFFER) {
+        descarregar();
+    }
+}
+
+void EscritorRelatorio::escreverInt(int valor) {
+    char digitos[16];
+    auto [fim, erro] = to_chars(digitos, digitos + sizeof(digitos), valor);
+    escrever(string_view(digitos, fim - digitos));
+}
+
+void EscritorRelatorio::escreverMesAno(const YearMonth& ym) {
+    char texto[TAMANHO_MAX_MES_ANO];
+    escrever(string_view(texto, formatarMesAno(texto, ym) - texto));
+}
+
+void EscritorRelatorio::escreverMoeda(Dinheiro valor) {
+    char texto[TAMANHO_MAX_MOEDA];
+    escrever(string_view(texto, formatarMoedaBr(texto, valor) - texto));
+}
+
+void EscritorRelatorio::fechar() {
+    if (fd < 0) {
+        return;
+    }
+    descarregar();
+    close(fd);
+    fd = -1;
+}
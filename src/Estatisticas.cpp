@@ -0,0 +1,233 @@
+#include "Estatisticas.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "Instrumentacao.h"
+#include "OrdenacaoExterna.h"
+#include "OrdenacaoParalela.h"
+
+using namespace std;
+
+namespace {
+
+// Sort key of a couple of 3-estatisticas-casais.csv
+struct ChaveCasal {
+    uint64_t totalInvertido;
+    uint32_t nome1; // Rank of the name among all names of the report
+    uint32_t nome2;
+    uint32_t linha; // Position in EstatisticasCasais::casais
+
+    bool operator<(const ChaveCasal& outra) const {
+        return tie(totalInvertido, nome1, nome2, linha)
+               < tie(outra.totalInvertido, outra.nome1, outra.nome2, outra.linha);
+    }
+};
+
+// Sort key of a row of 2-estatisticas-prestadores.csv; the row's position
+// breaks ties, so the comparison and the radix sort agree
+struct ChavePrestador {
+    uint64_t valor; // Cents with the sign bit flipped, inverted: largest first
+    uint32_t nome;  // Rank of the name among the providers' names
+    uint32_t linha;
+    uint16_t prioridade;
+
+    bool operator<(const ChavePrestador& outra) const {
+        return tie(prioridade, valor, nome, linha) < tie(outra.prioridade, outra.valor, outra.nome, outra.linha);
+    }
+};
+
+// Rows per parallel block; smaller inputs are aggregated on the calling thread
+constexpr size_t LINHAS_POR_BLOCO = 1 << 16;
+
+// Totals are kept in one array: what a Pessoa received through tarefas at
+// its own position, and through compras at numPessoas + its position
+struct Lancamento {
+    size_t posicao;
+    Dinheiro valor;
+};
+
+// Calls lancar(posicao, valor) for rows [inicio, fim), numbering the tarefas
+// first and the compras after them
+template <typename Lancar>
+void lancarLinhas(const Registro& registro, size_t inicio, size_t fim, Lancar lancar) {
+    const TabelaTarefas& tarefas = registro.getTabelaTarefas();
+    const TabelaCompras& compras = registro.getTabelaCompras();
+    size_t numTarefas = tarefas.size();
+    size_t numPessoas = registro.getPessoas().size();
+
+    for (size_t linha = inicio; linha < min(fim, numTarefas); linha++) {
+        size_t indice = registro.findIndicePessoaById(tarefas.idPrestador[linha]);
+        if (indice != Registro::NAO_ENCONTRADO) {
+            lancar(indice, tarefas.valorPrestador[linha]);
+        }
+    }
+    for (size_t linha = max(inicio, numTarefas); linha < fim; linha++) {
+        size_t c = linha - numTarefas;
+        size_t indice = registro.findIndicePessoaById(compras.idLoja[c]);
+        if (indice != Registro::NAO_ENCONTRADO) {
+            lancar(numPessoas + indice, compras.precoUnitario[c] * compras.qtdeProduto[c]);
+        }
+    }
+}
+
+int getTipoPrioridade(const Pessoa* p) {
+    if (p->isPessoaFisica()){
+        return 1; // Highest priority for PF
+    } else if (p->isLoja()) {
+        return 3; // Lowest priority for Loja
+    } else {
+        return 2; // Medium priority for PJ (not Loja)
+    }
+}
+
+} // namespace
+
+vector<ReceitaPrestador> calcularReceitaPrestadores(const Registro& registro, ThreadPool& pool) {
+    const vector<Pessoa*>& pessoas = registro.getPessoas();
+    size_t numPessoas = pessoas.size();
+    size_t numLinhas = registro.getTarefas().size() + registro.getCompras().size();
+    size_t numBlocos = (numLinhas + LINHAS_POR_BLOCO - 1) / LINHAS_POR_BLOCO;
+
+    vector<Dinheiro> total(2 * numPessoas);
+
+    if (pool.getNumThreads() > 1 && numBlocos > 1) {
+        // Each block files its rows into one bucket per partition of the
+        // totals array; each partition then adds up its buckets from every block
+        size_t numParticoes = pool.getNumThreads();
+        vector<vector<vector<Lancamento>>> baldes(numBlocos, vector<vector<Lancamento>>(numParticoes));
+
+        pool.paraCada(numBlocos, [&](size_t b) {
+            size_t inicio = b * LINHAS_POR_BLOCO;
+            size_t fim = min(numLinhas, inicio + LINHAS_POR_BLOCO);
+            lancarLinhas(registro, inicio, fim, [&](size_t posicao, Dinheiro valor) {
+                baldes[b][posicao % numParticoes].push_back({posicao, valor});
+            });
+        });
+
+        pool.paraCada(numParticoes, [&](size_t p) {
+            for (const vector<vector<Lancamento>>& doBloco : baldes) {
+                for (const Lancamento& lancamento : doBloco[p]) {
+                    total[lancamento.posicao] += lancamento.valor;
+                }
+            }
+        });
+    } else {
+        lancarLinhas(registro, 0, numLinhas, [&](size_t posicao, Dinheiro valor) {
+            total[posicao] += valor;
+        });
+    }
+
+    vector<ReceitaPrestador> receitas;
+    receitas.reserve(numPessoas);
+    for (size_t i = 0; i < numPessoas; i++) {
+        Pessoa* p = pessoas[i];
+        if (p->isPessoaFisica()) {
+            if (total[i] > Dinheiro()) {
+                receitas.push_back({p, total[i]});
+            }
+        } else if (p->isPessoaJuridica()) {
+            receitas.push_back({p, total[i]});
+        } else if (p->isLoja()) {
+            receitas.push_back({p, total[numPessoas + i]});
+        }
+    }
+    return receitas;
+}
+
+void ordenarReceitaPrestadores(vector<ReceitaPrestador>& receitas, ThreadPool& pool) {
+    Trecho trecho("ordenarReceitaPrestadores", "relatorio");
+    trecho.contarItens(receitas.size());
+
+    // Names are ranked once, so ordering the rows never compares text
+    vector<uint32_t> nomes;
+    nomes.reserve(receitas.size());
+    for (const ReceitaPrestador& receita : receitas) {
+        nomes.push_back(receita.pessoa->getNome().getHandle());
+    }
+    sort(nomes.begin(), nomes.end());
+    nomes.erase(unique(nomes.begin(), nomes.end()), nomes.end());
+    ordenarParalelo(nomes, [](uint32_t a, uint32_t b) { return Simbolo(a).texto() < Simbolo(b).texto(); }, pool);
+
+    vector<uint32_t> posicaoDoNome(nomes.empty() ? 0 : *max_element(nomes.begin(), nomes.end()) + 1);
+    for (size_t i = 0; i < nomes.size(); i++) {
+        posicaoDoNome[nomes[i]] = static_cast<uint32_t>(i);
+    }
+
+    // PF, then PJ (not Loja), then Loja; by value (descending), then by name
+    vector<ChavePrestador> chaves(receitas.size());
+    for (size_t i = 0; i < receitas.size(); i++) {
+        const Pessoa* p = receitas[i].pessoa;
+        uint64_t valor = ~(static_cast<uint64_t>(receitas[i].valor.getCentavos()) ^ (uint64_t{1} << 63));
+        chaves[i] = {valor, posicaoDoNome[p->getNome().getHandle()], static_cast<uint32_t>(i),
+                     static_cast<uint16_t>(getTipoPrioridade(p))};
+    }
+
+    if (chaves.size() < MINIMO_ORDENACAO_PARALELA) {
+        sort(chaves.begin(), chaves.end());
+    } else {
+        // Least significant first: name (2 digits), value (4), kind (1)
+        ordenarRadix(chaves, 7, [](const ChavePrestador& chave, size_t d) -> uint16_t {
+            if (d < 2) {
+                return static_cast<uint16_t>(chave.nome >> (16 * d));
+            }
+            if (d < 6) {
+                return static_cast<uint16_t>(chave.valor >> (16 * (d - 2)));
+            }
+            return chave.prioridade;
+        }, pool);
+    }
+
+    vector<ReceitaPrestador> ordenadas;
+    ordenadas.reserve(receitas.size());
+    for (const ChavePrestador& chave : chaves) {
+        ordenadas.push_back(receitas[chave.linha]);
+    }
+    receitas.swap(ordenadas);
+}
+
+void EstatisticasCasais::adicionar(Simbolo nomeA, Simbolo nomeB, Dinheiro totalGasto, int festasEmComum) {
+    numLinhas++;
+    auto [it, novo] = porNomes.try_emplace(Registro::chaveCasal(nomeA, nomeB), static_cast<uint32_t>(casais.size()));
+    if (novo) {
+        if (nomeB.texto() < nomeA.texto()) {
+            swap(nomeA, nomeB);
+        }
+        casais.push_back({nomeA, nomeB, totalGasto, 0, 0});
+    }
+    LinhaCasal& casal = casais[it->second];
+    casal.totalGasto = totalGasto;
+    casal.festasEmComum += festasEmComum;
+    casal.linhas++;
+}
+
+void EstatisticasCasais::visitarEmOrdem(size_t orcamentoBytes, const function<void(const LinhaCasal&)>& visitar) const {
+    // Names are ranked once, so the sort itself never compares text
+    vector<uint32_t> nomes;
+    nomes.reserve(2 * casais.size());
+    for (const LinhaCasal& casal : casais) {
+        nomes.push_back(casal.nome1.getHandle());
+        nomes.push_back(casal.nome2.getHandle());
+    }
+    sort(nomes.begin(), nomes.end());
+    nomes.erase(unique(nomes.begin(), nomes.end()), nomes.end());
+    sort(nomes.begin(), nomes.end(),
+         [](uint32_t a, uint32_t b) { return Simbolo(a).texto() < Simbolo(b).texto(); });
+
+    vector<uint32_t> posicaoDoNome(nomes.empty() ? 0 : *max_element(nomes.begin(), nomes.end()) + 1);
+    for (size_t i = 0; i < nomes.size(); i++) {
+        posicaoDoNome[nomes[i]] = static_cast<uint32_t>(i);
+    }
+    vector<uint32_t>().swap(nomes);
+
+    auto chave = [&](size_t linha) {
+        const LinhaCasal& casal = casais[linha];
+        // Flipping the sign bit orders the cents as unsigned; inverting that
+        // puts the largest total first
+        uint64_t total = ~(static_cast<uint64_t>(casal.totalGasto.getCentavos()) ^ (uint64_t{1} << 63));
+        return ChaveCasal{total, posicaoDoNome[casal.nome1.getHandle()], posicaoDoNome[casal.nome2.getHandle()],
+                          static_cast<uint32_t>(linha)};
+    };
+    ordenarComOrcamento<ChaveCasal>(
+        casais.size(), chave, [&](const ChaveCasal& c) { visitar(casais[c.linha]); }, orcamentoBytes);
+}
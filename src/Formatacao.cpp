@@ -0,0 +1,84 @@
+#include "Formatacao.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+// Below this, value * 100 stays under 2^52: the product, its integer part and
+// its fraction are all exact doubles and the cents fit an integer
+constexpr double LIMITE_CENTAVOS_EXATOS = 4.0e13;
+
+} // namespace
+
+char* formatarMoedaBr(char* saida, double valor) {
+    *saida++ = 'R';
+    *saida++ = '$';
+    *saida++ = ' ';
+
+    double absoluto = fabs(valor);
+    if (!(absoluto < LIMITE_CENTAVOS_EXATOS)) {
+        // Huge amounts, inf and nan go through the generic conversion
+        char* fim = to_chars(saida, saida + TAMANHO_MAX_MOEDA - 3, valor, chars_format::fixed, 2).ptr;
+        if (fim[-3] == '.') {
+            fim[-3] = ',';
+        }
+        return fim;
+    }
+
+    if (signbit(valor)) {
+        *saida++ = '-';
+    }
+
+    // absoluto * 100 == produto + erro exactly. The cents are rounded to
+    // nearest, ties to even, on that exact value, which is what printf does.
+    double produto = absoluto * 100.0;
+    double erro = fma(absoluto, 100.0, -produto);
+    double inteiro = floor(produto);
+    double distanciaMeio = (produto - inteiro) - 0.5;
+
+    uint64_t centavos = static_cast<uint64_t>(inteiro);
+    if (distanciaMeio > -erro || (distanciaMeio == -erro && (centavos & 1))) {
+        centavos++;
+    }
+
+    saida = to_chars(saida, saida + 20, centavos / 100).ptr;
+    unsigned resto = static_cast<unsigned>(centavos % 100);
+    *saida++ = ',';
+    *saida++ = static_cast<char>('0' + resto / 10);
+    *saida++ = static_cast<char>('0' + resto % 10);
+    return saida;
+}
+
+char* formatarMoedaBr(char* saida, Dinheiro valor) {
+    *saida++ = 'R';
+    *saida++ = '$';
+    *saida++ = ' ';
+
+    int64_t centavos = valor.getCentavos();
+    uint64_t absoluto = static_cast<uint64_t>(centavos);
+    if (centavos < 0) {
+        *saida++ = '-';
+        absoluto = 0 - absoluto;
+    }
+
+    saida = to_chars(saida, saida + 20, absoluto / 100).ptr;
+    unsigned resto = static_cast<unsigned>(absoluto % 100);
+    *saida++ = ',';
+    *saida++ = static_cast<char>('0' + resto / 10);
+    *saida++ = static_cast<char>('0' + resto % 10);
+    return saida;
+}
+
+char* formatarMesAno(char* saida, const YearMonth& ym) {
+    int mes = ym.getMonth();
+    if (mes >= 0 && mes < 10) {
+        *saida++ = '0';
+    }
+    saida = to_chars(saida, saida + 11, mes).ptr;
+    *saida++ = '/';
+    return to_chars(saida, saida + 11, ym.getYear()).ptr;
+}
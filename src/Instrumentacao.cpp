@@ -0,0 +1,282 @@
+#include "Instrumentacao.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "Json.h"
+
+using namespace std;
+
+bool instrumentacaoLigada = false;
+
+namespace {
+
+struct Evento {
+    const char* nome;
+    const char* categoria;
+    uint64_t inicio;
+    uint64_t duracao;
+    uint64_t itens;
+    uint64_t bytes;
+};
+
+// Written only by its own thread; read when the report is written, after
+// the workers are idle
+struct BufferThread {
+    size_t indice = 0;
+    vector<Evento> eventos;
+    uint64_t buscas = 0;
+};
+
+mutex mutexBuffers;
+vector<unique_ptr<BufferThread>> buffers; // Never shrinks: threads keep a pointer to theirs
+atomic<uint64_t> alocacoes{0};
+uint64_t inicioExecucao = 0;
+
+BufferThread& bufferDaThread() {
+    thread_local BufferThread* buffer = nullptr;
+    if (!buffer) {
+        lock_guard<mutex> trava(mutexBuffers);
+        buffers.push_back(make_unique<BufferThread>());
+        buffer = buffers.back().get();
+        buffer->indice = buffers.size();
+        buffer->eventos.reserve(1024);
+    }
+    return *buffer;
+}
+
+// Nearest-rank percentile of sorted durations
+uint64_t percentil(const vector<uint64_t>& ordenados, double p) {
+    if (ordenados.empty()) {
+        return 0;
+    }
+    size_t posicao = static_cast<size_t>(ceil(p * static_cast<double>(ordenados.size())));
+    return ordenados[max<size_t>(posicao, 1) - 1];
+}
+
+double micros(uint64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+uint64_t totalBuscas() {
+    uint64_t total = 0;
+    for (const auto& buffer : buffers) {
+        total += buffer->buscas;
+    }
+    return total;
+}
+
+void gravarJson(const string& caminho, const string& json) {
+    ofstream arquivo(caminho, ios::binary | ios::trunc);
+    arquivo << json;
+    if (!arquivo) {
+        throw runtime_error("cannot write " + caminho);
+    }
+}
+
+} // namespace
+
+// Counting allocations means owning the global allocator; while the
+// instrumentation is off this is malloc behind one predictable branch
+void* operator new(size_t tamanho) {
+    if (instrumentacaoLigada) {
+        alocacoes.fetch_add(1, memory_order_relaxed);
+    }
+    if (tamanho == 0) {
+        tamanho = 1;
+    }
+    while (true) {
+        if (void* memoria = malloc(tamanho)) {
+            return memoria;
+        }
+        new_handler tratador = get_new_handler();
+        if (!tratador) {
+            throw bad_alloc();
+        }
+        tratador();
+    }
+}
+
+// GCC flags free() once these are inlined next to a new-expression, though
+// the memory did come from malloc above
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void operator delete(void* memoria) noexcept {
+    free(memoria);
+}
+
+void operator delete(void* memoria, size_t) noexcept {
+    free(memoria);
+}
+
+#pragma GCC diagnostic pop
+
+void ligarInstrumentacao() {
+    inicioExecucao = instanteNs();
+    bufferDaThread(); // The calling thread gets the first track
+    instrumentacaoLigada = true;
+}
+
+uint64_t instanteNs() {
+    return static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void registrarTrecho(const char* nome, const char* categoria, uint64_t inicio, uint64_t itens, uint64_t bytes) {
+    uint64_t fim = instanteNs();
+    bufferDaThread().eventos.push_back({nome, categoria, inicio, fim - inicio, itens, bytes});
+}
+
+void registrarBusca() {
+    bufferDaThread().buscas++;
+}
+
+void gravarResumoInstrumentacao(const string& caminho) {
+    struct Resumo {
+        const char* categoria;
+        vector<uint64_t> duracoes;
+        uint64_t itens = 0;
+        uint64_t bytes = 0;
+    };
+
+    lock_guard<mutex> trava(mutexBuffers);
+    map<string, Resumo> resumos;
+    for (const auto& buffer : buffers) {
+        for (const Evento& evento : buffer->eventos) {
+            Resumo& resumo = resumos[evento.nome];
+            resumo.categoria = evento.categoria;
+            resumo.duracoes.push_back(evento.duracao);
+            resumo.itens += evento.itens;
+            resumo.bytes += evento.bytes;
+        }
+    }
+
+    string json = "{\"duracaoMicros\":";
+    anexarRealJson(json, micros(instanteNs() - inicioExecucao));
+    json += ",\"threads\":";
+    anexarInteiroJson(json, static_cast<int64_t>(buffers.size()));
+
+    json += ",\"trechos\":[";
+    bool primeiro = true;
+    for (auto& [nome, resumo] : resumos) {
+        vector<uint64_t>& duracoes = resumo.duracoes;
+        sort(duracoes.begin(), duracoes.end());
+        uint64_t total = 0;
+        // Bucket k counts the calls that took [2^k, 2^(k+1)) microseconds;
+        // bucket 0 also holds the ones under a microsecond
+        vector<uint64_t> histograma;
+        for (uint64_t duracao : duracoes) {
+            total += duracao;
+            uint64_t us = max<uint64_t>(duracao / 1000, 1);
+            size_t balde = static_cast<size_t>(63 - __builtin_clzll(us));
+            if (histograma.size() <= balde) {
+                histograma.resize(balde + 1);
+            }
+            histograma[balde]++;
+        }
+        double segundos = static_cast<double>(total) / 1e9;
+
+        json += primeiro ? "{\"nome\":" : ",{\"nome\":";
+        primeiro = false;
+        anexarTextoJson(json, nome);
+        json += ",\"categoria\":";
+        anexarTextoJson(json, resumo.categoria);
+        json += ",\"chamadas\":";
+        anexarInteiroJson(json, static_cast<int64_t>(duracoes.size()));
+        json += ",\"totalMicros\":";
+        anexarRealJson(json, micros(total));
+        json += ",\"p50Micros\":";
+        anexarRealJson(json, micros(percentil(duracoes, 0.50)));
+        json += ",\"p99Micros\":";
+        anexarRealJson(json, micros(percentil(duracoes, 0.99)));
+        json += ",\"maxMicros\":";
+        anexarRealJson(json, micros(duracoes.back()));
+        json += ",\"histogramaLog2Micros\":[";
+        for (size_t k = 0; k < histograma.size(); k++) {
+            if (k > 0) {
+                json += ',';
+            }
+            anexarInteiroJson(json, static_cast<int64_t>(histograma[k]));
+        }
+        json += ']';
+        if (resumo.itens > 0) {
+            json += ",\"itens\":";
+            anexarInteiroJson(json, static_cast<int64_t>(resumo.itens));
+            json += ",\"itensPorSegundo\":";
+            anexarRealJson(json, segundos > 0 ? static_cast<double>(resumo.itens) / segundos : 0.0);
+        }
+        if (resumo.bytes > 0) {
+            json += ",\"bytes\":";
+            anexarInteiroJson(json, static_cast<int64_t>(resumo.bytes));
+            json += ",\"bytesPorSegundo\":";
+            anexarRealJson(json, segundos > 0 ? static_cast<double>(resumo.bytes) / segundos : 0.0);
+        }
+        json += '}';
+    }
+
+    json += "],\"contadores\":{\"buscas\":";
+    anexarInteiroJson(json, static_cast<int64_t>(totalBuscas()));
+    json += ",\"alocacoes\":";
+    anexarInteiroJson(json, static_cast<int64_t>(alocacoes.load(memory_order_relaxed)));
+    json += "}}\n";
+
+    gravarJson(caminho, json);
+}
+
+void gravarTraceInstrumentacao(const string& caminho) {
+    lock_guard<mutex> trava(mutexBuffers);
+    string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool primeiro = true;
+    for (const auto& buffer : buffers) {
+        json += primeiro ? "{" : ",{";
+        primeiro = false;
+        json += "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        anexarInteiroJson(json, static_cast<int64_t>(buffer->indice));
+        json += ",\"args\":{\"name\":";
+        anexarTextoJson(json, buffer->indice == 1 ? "principal" : "thread " + to_string(buffer->indice));
+        json += "}}";
+
+        for (const Evento& evento : buffer->eventos) {
+            json += ",{\"name\":";
+            anexarTextoJson(json, evento.nome);
+            json += ",\"cat\":";
+            anexarTextoJson(json, evento.categoria);
+            json += ",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            anexarInteiroJson(json, static_cast<int64_t>(buffer->indice));
+            json += ",\"ts\":";
+            anexarRealJson(json, micros(evento.inicio - inicioExecucao));
+            json += ",\"dur\":";
+            anexarRealJson(json, micros(evento.duracao));
+            if (evento.itens > 0 || evento.bytes > 0) {
+                json += ",\"args\":{\"itens\":";
+                anexarInteiroJson(json, static_cast<int64_t>(evento.itens));
+                json += ",\"bytes\":";
+                anexarInteiroJson(json, static_cast<int64_t>(evento.bytes));
+                json += '}';
+            }
+            json += '}';
+        }
+    }
+
+    json += primeiro ? "{" : ",{";
+    json += "\"name\":\"contadores\",\"ph\":\"C\",\"pid\":1,\"ts\":";
+    anexarRealJson(json, micros(instanteNs() - inicioExecucao));
+    json += ",\"args\":{\"buscas\":";
+    anexarInteiroJson(json, static_cast<int64_t>(totalBuscas()));
+    json += ",\"alocacoes\":";
+    anexarInteiroJson(json, static_cast<int64_t>(alocacoes.load(memory_order_relaxed)));
+    json += "}}]}\n";
+
+    gravarJson(caminho, json);
+}
@@ -0,0 +1,150 @@
+#include "Intersecao.h"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define INTERSECAO_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Above this size ratio, searching each value of the short list in the long
+// one beats walking both
+constexpr size_t RAZAO_BUSCA_BINARIA = 32;
+
+using Kernel = size_t (*)(const uint32_t*, size_t, const uint32_t*, size_t);
+
+// Plain merge from positions i and j to the end of both lists
+size_t intersecaoEscalar(const uint32_t* a, size_t i, size_t tamanhoA,
+                         const uint32_t* b, size_t j, size_t tamanhoB) {
+    size_t total = 0;
+    while (i < tamanhoA && j < tamanhoB) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            total++;
+            i++;
+            j++;
+        }
+    }
+    return total;
+}
+
+size_t kernelEscalar(const uint32_t* a, size_t tamanhoA, const uint32_t* b, size_t tamanhoB) {
+    return intersecaoEscalar(a, 0, tamanhoA, b, 0, tamanhoB);
+}
+
+size_t intersecaoPorBusca(const uint32_t* curta, size_t tamanhoCurta, const uint32_t* longa, size_t tamanhoLonga) {
+    size_t total = 0;
+    const uint32_t* inicio = longa;
+    const uint32_t* fim = longa + tamanhoLonga;
+    for (size_t i = 0; i < tamanhoCurta && inicio != fim; i++) {
+        inicio = lower_bound(inicio, fim, curta[i]);
+        if (inicio != fim && *inicio == curta[i]) {
+            total++;
+            inicio++;
+        }
+    }
+    return total;
+}
+
+#ifdef INTERSECAO_X86
+
+// Compares a block of 4 values of each list against every rotation of the
+// other block; since the values are unique, each lane of a matches at most once.
+// The block with the smaller last value is consumed.
+__attribute__((target("sse2")))
+size_t kernelSse2(const uint32_t* a, size_t tamanhoA, const uint32_t* b, size_t tamanhoB) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t total = 0;
+    while (i + 4 <= tamanhoA && j + 4 <= tamanhoB) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+        __m128i iguais = _mm_cmpeq_epi32(va, vb);
+        iguais = _mm_or_si128(iguais, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        iguais = _mm_or_si128(iguais, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        iguais = _mm_or_si128(iguais, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        total += static_cast<size_t>(__builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(iguais))));
+
+        uint32_t ultimoA = a[i + 3];
+        uint32_t ultimoB = b[j + 3];
+        if (ultimoA <= ultimoB) {
+            i += 4;
+        }
+        if (ultimoB <= ultimoA) {
+            j += 4;
+        }
+    }
+    return total + intersecaoEscalar(a, i, tamanhoA, b, j, tamanhoB);
+}
+
+// Same scheme with blocks of 8 values
+__attribute__((target("avx2")))
+size_t kernelAvx2(const uint32_t* a, size_t tamanhoA, const uint32_t* b, size_t tamanhoB) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t total = 0;
+    const __m256i rotacao = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= tamanhoA && j + 8 <= tamanhoB) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+
+        __m256i iguais = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotacao);
+            iguais = _mm256_or_si256(iguais, _mm256_cmpeq_epi32(va, vb));
+        }
+        total += static_cast<size_t>(__builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(iguais))));
+
+        uint32_t ultimoA = a[i + 7];
+        uint32_t ultimoB = b[j + 7];
+        if (ultimoA <= ultimoB) {
+            i += 8;
+        }
+        if (ultimoB <= ultimoA) {
+            j += 8;
+        }
+    }
+    return total + intersecaoEscalar(a, i, tamanhoA, b, j, tamanhoB);
+}
+
+#endif
+
+Kernel escolherKernel() {
+#ifdef INTERSECAO_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return kernelAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return kernelSse2;
+    }
+#endif
+    return kernelEscalar;
+}
+
+} // namespace
+
+size_t contarIntersecao(const uint32_t* a, size_t tamanhoA, const uint32_t* b, size_t tamanhoB) {
+    static const Kernel kernel = escolherKernel();
+
+    if (tamanhoA > tamanhoB) {
+        swap(a, b);
+        swap(tamanhoA, tamanhoB);
+    }
+    if (tamanhoA == 0) {
+        return 0;
+    }
+    if (tamanhoB / tamanhoA >= RAZAO_BUSCA_BINARIA) {
+        return intersecaoPorBusca(a, tamanhoA, b, tamanhoB);
+    }
+    return kernel(a, tamanhoA, b, tamanhoB);
+}
@@ -0,0 +1,236 @@
+#include "Json.h"
+
+#include <charconv>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+class LeitorJson {
+private:
+    string_view resto;
+
+    static bool espaco(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    static int valorHex(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static void anexarUtf8(string& destino, uint32_t ponto) {
+        if (ponto < 0x80) {
+            destino += static_cast<char>(ponto);
+        } else if (ponto < 0x800) {
+            destino += static_cast<char>(0xC0 | (ponto >> 6));
+            destino += static_cast<char>(0x80 | (ponto & 0x3F));
+        } else if (ponto < 0x10000) {
+            destino += static_cast<char>(0xE0 | (ponto >> 12));
+            destino += static_cast<char>(0x80 | ((ponto >> 6) & 0x3F));
+            destino += static_cast<char>(0x80 | (ponto & 0x3F));
+        } else {
+            destino += static_cast<char>(0xF0 | (ponto >> 18));
+            destino += static_cast<char>(0x80 | ((ponto >> 12) & 0x3F));
+            destino += static_cast<char>(0x80 | ((ponto >> 6) & 0x3F));
+            destino += static_cast<char>(0x80 | (ponto & 0x3F));
+        }
+    }
+
+    optional<uint32_t> lerHex4() {
+        if (resto.size() < 4) {
+            return nullopt;
+        }
+        uint32_t valor = 0;
+        for (int i = 0; i < 4; i++) {
+            int digito = valorHex(resto[i]);
+            if (digito < 0) {
+                return nullopt;
+            }
+            valor = (valor << 4) | static_cast<uint32_t>(digito);
+        }
+        resto.remove_prefix(4);
+        return valor;
+    }
+
+public:
+    explicit LeitorJson(string_view texto) : resto(texto) {}
+
+    void pularEspacos() {
+        while (!resto.empty() && espaco(resto.front())) {
+            resto.remove_prefix(1);
+        }
+    }
+
+    bool fim() const { return resto.empty(); }
+
+    bool consumir(char c) {
+        pularEspacos();
+        if (resto.empty() || resto.front() != c) {
+            return false;
+        }
+        resto.remove_prefix(1);
+        return true;
+    }
+
+    bool proximoE(char c) {
+        pularEspacos();
+        return !resto.empty() && resto.front() == c;
+    }
+
+    optional<string> lerTexto() {
+        if (!consumir('"')) {
+            return nullopt;
+        }
+        string texto;
+        while (!resto.empty()) {
+            char c = resto.front();
+            resto.remove_prefix(1);
+            if (c == '"') {
+                return texto;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return nullopt;
+            }
+            if (c != '\\') {
+                texto += c;
+                continue;
+            }
+            if (resto.empty()) {
+                return nullopt;
+            }
+            char escape = resto.front();
+            resto.remove_prefix(1);
+            switch (escape) {
+            case '"': texto += '"'; break;
+            case '\\': texto += '\\'; break;
+            case '/': texto += '/'; break;
+            case 'b': texto += '\b'; break;
+            case 'f': texto += '\f'; break;
+            case 'n': texto += '\n'; break;
+            case 'r': texto += '\r'; break;
+            case 't': texto += '\t'; break;
+            case 'u': {
+                optional<uint32_t> ponto = lerHex4();
+                if (!ponto) {
+                    return nullopt;
+                }
+                // A high surrogate must be followed by its low half
+                if (*ponto >= 0xD800 && *ponto <= 0xDBFF) {
+                    if (resto.size() < 2 || resto[0] != '\\' || resto[1] != 'u') {
+                        return nullopt;
+                    }
+                    resto.remove_prefix(2);
+                    optional<uint32_t> baixo = lerHex4();
+                    if (!baixo || *baixo < 0xDC00 || *baixo > 0xDFFF) {
+                        return nullopt;
+                    }
+                    *ponto = 0x10000 + ((*ponto - 0xD800) << 10) + (*baixo - 0xDC00);
+                } else if (*ponto >= 0xDC00 && *ponto <= 0xDFFF) {
+                    return nullopt;
+                }
+                anexarUtf8(texto, *ponto);
+                break;
+            }
+            default:
+                return nullopt;
+            }
+        }
+        return nullopt;
+    }
+
+    // Number, true, false or null, as written
+    optional<string> lerLiteral() {
+        pularEspacos();
+        size_t tamanho = 0;
+        while (tamanho < resto.size()) {
+            char c = resto[tamanho];
+            bool valido = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.'
+                          || c == 'E';
+            if (!valido) {
+                break;
+            }
+            tamanho++;
+        }
+        if (tamanho == 0) {
+            return nullopt;
+        }
+        string literal(resto.substr(0, tamanho));
+        resto.remove_prefix(tamanho);
+        return literal;
+    }
+};
+
+} // namespace
+
+optional<ObjetoJson> lerObjetoJson(string_view texto) {
+    LeitorJson leitor(texto);
+    ObjetoJson objeto;
+
+    if (!leitor.consumir('{')) {
+        return nullopt;
+    }
+    if (!leitor.consumir('}')) {
+        do {
+            optional<string> chave = leitor.lerTexto();
+            if (!chave || !leitor.consumir(':')) {
+                return nullopt;
+            }
+            optional<string> valor = leitor.proximoE('"') ? leitor.lerTexto() : leitor.lerLiteral();
+            if (!valor) {
+                return nullopt;
+            }
+            objeto[move(*chave)] = move(*valor);
+        } while (leitor.consumir(','));
+
+        if (!leitor.consumir('}')) {
+            return nullopt;
+        }
+    }
+
+    leitor.pularEspacos();
+    if (!leitor.fim()) {
+        return nullopt;
+    }
+    return objeto;
+}
+
+void anexarTextoJson(string& destino, string_view texto) {
+    static const char HEX[] = "0123456789abcdef";
+    destino += '"';
+    for (char c : texto) {
+        switch (c) {
+        case '"': destino += "\\\""; break;
+        case '\\': destino += "\\\\"; break;
+        case '\n': destino += "\\n"; break;
+        case '\r': destino += "\\r"; break;
+        case '\t': destino += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                destino += "\\u00";
+                destino += HEX[(c >> 4) & 0xF];
+                destino += HEX[c & 0xF];
+            } else {
+                destino += c;
+            }
+        }
+    }
+    destino += '"';
+}
+
+void anexarInteiroJson(string& destino, int64_t valor) {
+    char texto[24];
+    char* fim = to_chars(texto, texto + sizeof(texto), valor).ptr;
+    destino.append(texto, fim);
+}
+
+void anexarRealJson(string& destino, double valor) {
+    if (!isfinite(valor)) {
+        destino += "null";
+        return;
+    }
+    char texto[32];
+    char* fim = to_chars(texto, texto + sizeof(texto), valor).ptr;
+    destino.append(texto, fim);
+}
@@ -0,0 +1,262 @@
+#include "LeitorCSV.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+ArquivoMapeado::ArquivoMapeado(const string& caminho) {
+    int fd = open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        tamanho = static_cast<size_t>(info.st_size);
+        if (tamanho == 0) {
+            aberto = true; // mmap refuses empty ranges; an empty file has no lines
+        } else {
+            void* mapa = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapa != MAP_FAILED) {
+                madvise(mapa, tamanho, MADV_SEQUENTIAL);
+                dados = static_cast<const char*>(mapa);
+                aberto = true;
+            } else {
+                tamanho = 0;
+            }
+        }
+    }
+    close(fd);
+}
+
+ArquivoMapeado::~ArquivoMapeado() {
+    if (dados) {
+        munmap(const_cast<char*>(dados), tamanho);
+    }
+}
+
+bool LeitorCSV::proximaLinha() {
+    while (!resto.empty()) {
+        size_t fim = resto.find('\n');
+        string_view linha = resto.substr(0, fim);
+        resto.remove_prefix(fim == string_view::npos ? resto.size() : fim + 1);
+
+        if (linha.empty()) {
+            continue;
+        }
+
+        campos.clear();
+        size_t inicio = 0;
+        size_t separador;
+        while ((separador = linha.find(';', inicio)) != string_view::npos) {
+            campos.push_back(linha.substr(inicio, separador - inicio));
+            inicio = separador + 1;
+        }
+        campos.push_back(linha.substr(inicio));
+        return true;
+    }
+    return false;
+}
+
+vector<string_view> dividirEmTrechos(string_view conteudo, size_t maxTrechos, size_t tamanhoMinimo) {
+    vector<string_view> trechos;
+    size_t alvo = max(tamanhoMinimo, conteudo.size() / max<size_t>(1, maxTrechos) + 1);
+
+    while (!conteudo.empty()) {
+        size_t corte = conteudo.size();
+        if (alvo < conteudo.size()) {
+            size_t fimLinha = conteudo.find('\n', alvo);
+            if (fimLinha != string_view::npos) {
+                corte = fimLinha + 1;
+            }
+        }
+        trechos.push_back(conteudo.substr(0, corte));
+        conteudo.remove_prefix(corte);
+    }
+    return trechos;
+}
+
+vector<string_view> dividirCampo(string_view campo, char delimitador) {
+    vector<string_view> partes;
+    size_t inicio = 0;
+    size_t separador;
+    while ((separador = campo.find(delimitador, inicio)) != string_view::npos) {
+        partes.emplace_back(campo.substr(inicio, separador - inicio));
+        inicio = separador + 1;
+    }
+    partes.emplace_back(campo.substr(inicio));
+    return partes;
+}
+
+namespace {
+
+// Skips the whitespace and '+' sign that stoi/stod accept but from_chars does not
+const char* inicioNumero(string_view campo) {
+    const char* p = campo.data();
+    const char* fim = p + campo.size();
+    while (p != fim && isspace(static_cast<unsigned char>(*p))) {
+        p++;
+    }
+    if (p != fim && *p == '+' && p + 1 != fim && p[1] != '-') {
+        p++;
+    }
+    return p;
+}
+
+template <typename T, typename... Formato>
+T converter(string_view campo, const char* funcao, Formato... formato) {
+    T valor{};
+    const char* fim = campo.data() + campo.size();
+    auto [ptr, ec] = from_chars(inicioNumero(campo), fim, valor, formato...);
+    if (ec == errc::invalid_argument) {
+        throw invalid_argument(funcao);
+    }
+    if (ec == errc::result_out_of_range) {
+        throw out_of_range(funcao);
+    }
+    return valor;
+}
+
+bool ehDigito(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// The pieces of a "-1.234,56" field. inteira keeps its grouping dots.
+struct CampoDecimal {
+    bool negativo = false;
+    string_view inteira;
+    string_view fracao;
+};
+
+// Reads sign, integer part and decimals the way stod reads a number: leading
+// whitespace is skipped and the number ends at the first character that does
+// not belong to it. A '.' followed by exactly three digits groups thousands;
+// the decimal separator is ',' (or a '.' that is not a thousands group).
+CampoDecimal separarDecimal(string_view campo, const char* funcao) {
+    const char* p = inicioNumero(campo);
+    const char* fim = campo.data() + campo.size();
+    CampoDecimal decimal;
+
+    if (p != fim && *p == '-') {
+        decimal.negativo = true;
+        p++;
+    }
+
+    const char* inicio = p;
+    while (p != fim) {
+        if (ehDigito(*p)) {
+            p++;
+        } else if (*p == '.' && p != inicio && fim - p >= 4 && ehDigito(p[1]) && ehDigito(p[2]) && ehDigito(p[3])
+                   && (fim - p == 4 || !ehDigito(p[4]))) {
+            p += 4;
+        } else {
+            break;
+        }
+    }
+    decimal.inteira = string_view(inicio, p - inicio);
+
+    if (p != fim && (*p == ',' || *p == '.')) {
+        const char* inicioFracao = ++p;
+        while (p != fim && ehDigito(*p)) {
+            p++;
+        }
+        decimal.fracao = string_view(inicioFracao, p - inicioFracao);
+    }
+
+    if (decimal.inteira.empty() && decimal.fracao.empty()) {
+        throw invalid_argument(funcao);
+    }
+    return decimal;
+}
+
+// Powers of ten that are exact doubles
+constexpr double POTENCIAS_DE_DEZ[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+} // namespace
+
+int paraInt(string_view campo) {
+    return converter<int>(campo, "paraInt");
+}
+
+double paraDecimalBr(string_view campo) {
+    CampoDecimal decimal = separarDecimal(campo, "paraDecimalBr");
+
+    // Up to 15 significant digits the value is an exact integer divided by an
+    // exact power of ten, and that single division is correctly rounded
+    uint64_t mantissa = 0;
+    int digitos = 0;
+    for (char c : decimal.inteira) {
+        if (c != '.') {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            digitos++;
+        }
+    }
+    for (char c : decimal.fracao) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+    }
+    digitos += static_cast<int>(decimal.fracao.size());
+
+    if (digitos <= 15 && decimal.fracao.size() <= 22) {
+        double valor = static_cast<double>(mantissa) / POTENCIAS_DE_DEZ[decimal.fracao.size()];
+        return decimal.negativo ? -valor : valor;
+    }
+
+    // Longer fields go through from_chars on the dotless, '.'-decimal text
+    string normalizado;
+    normalizado.reserve(decimal.inteira.size() + decimal.fracao.size() + 2);
+    if (decimal.negativo) {
+        normalizado.push_back('-');
+    }
+    for (char c : decimal.inteira) {
+        if (c != '.') {
+            normalizado.push_back(c);
+        }
+    }
+    normalizado.push_back('.');
+    normalizado.append(decimal.fracao);
+
+    double valor = 0.0;
+    auto [ptr, ec] = from_chars(normalizado.data(), normalizado.data() + normalizado.size(), valor,
+                                chars_format::fixed);
+    if (ec == errc::result_out_of_range) {
+        throw out_of_range("paraDecimalBr");
+    }
+    return valor;
+}
+
+int64_t paraCentavosBr(string_view campo) {
+    CampoDecimal decimal = separarDecimal(campo, "paraCentavosBr");
+
+    int64_t centavos = 0;
+    auto acrescentar = [&](char c) {
+        if (__builtin_mul_overflow(centavos, 10, &centavos) || __builtin_add_overflow(centavos, c - '0', &centavos)) {
+            throw out_of_range("paraCentavosBr");
+        }
+    };
+
+    for (char c : decimal.inteira) {
+        if (c != '.') {
+            acrescentar(c);
+        }
+    }
+    for (size_t i = 0; i < 2; i++) {
+        acrescentar(i < decimal.fracao.size() ? decimal.fracao[i] : '0');
+    }
+    // Further decimals round half away from zero
+    if (decimal.fracao.size() > 2 && decimal.fracao[2] >= '5') {
+        if (__builtin_add_overflow(centavos, 1, &centavos)) {
+            throw out_of_range("paraCentavosBr");
+        }
+    }
+
+    return decimal.negativo ? -centavos : centavos;
+}
@@ -0,0 +1,87 @@
+#include "Medicao.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <sys/resource.h>
+
+#include "Json.h"
+
+using namespace std;
+
+namespace {
+
+// Nearest-rank percentile of sorted values
+double percentil(const vector<double>& ordenados, double p) {
+    if (ordenados.empty()) {
+        return 0.0;
+    }
+    size_t posicao = static_cast<size_t>(ceil(p * static_cast<double>(ordenados.size())));
+    return ordenados[max<size_t>(posicao, 1) - 1];
+}
+
+} // namespace
+
+void Medicao::registrarFase(string nome, double segundos, uint64_t itens, uint64_t bytes) {
+    fases.push_back({move(nome), segundos, itens, bytes});
+}
+
+void Medicao::registrarLatencias(const vector<double>& segundosPorCasal) {
+    lock_guard<mutex> trava(mutexLatencias);
+    latencias.insert(latencias.end(), segundosPorCasal.begin(), segundosPorCasal.end());
+}
+
+void Medicao::gravar(const string& caminho, size_t numThreads) {
+    string json = "{\"threads\":";
+    anexarInteiroJson(json, static_cast<int64_t>(numThreads));
+
+    json += ",\"fases\":[";
+    for (size_t i = 0; i < fases.size(); i++) {
+        const Fase& fase = fases[i];
+        json += i > 0 ? ",{\"nome\":" : "{\"nome\":";
+        anexarTextoJson(json, fase.nome);
+        json += ",\"segundos\":";
+        anexarRealJson(json, fase.segundos);
+        json += ",\"itens\":";
+        anexarInteiroJson(json, static_cast<int64_t>(fase.itens));
+        json += ",\"itensPorSegundo\":";
+        anexarRealJson(json, fase.segundos > 0 ? static_cast<double>(fase.itens) / fase.segundos : 0.0);
+        if (fase.bytes > 0) {
+            json += ",\"bytes\":";
+            anexarInteiroJson(json, static_cast<int64_t>(fase.bytes));
+            json += ",\"bytesPorSegundo\":";
+            anexarRealJson(json, fase.segundos > 0 ? static_cast<double>(fase.bytes) / fase.segundos : 0.0);
+        }
+        json += '}';
+    }
+
+    sort(latencias.begin(), latencias.end());
+    json += "],\"latenciaCasalMicros\":{\"casais\":";
+    anexarInteiroJson(json, static_cast<int64_t>(latencias.size()));
+    json += ",\"p50\":";
+    anexarRealJson(json, percentil(latencias, 0.50) * 1e6);
+    json += ",\"p99\":";
+    anexarRealJson(json, percentil(latencias, 0.99) * 1e6);
+    json += ",\"max\":";
+    anexarRealJson(json, latencias.empty() ? 0.0 : latencias.back() * 1e6);
+
+    // ru_maxrss is in KiB on Linux
+    rusage uso{};
+    getrusage(RUSAGE_SELF, &uso);
+    json += "},\"picoRssKiB\":";
+    anexarInteiroJson(json, static_cast<int64_t>(uso.ru_maxrss));
+    json += "}\n";
+
+    if (caminho == "-") {
+        cout << json << flush;
+        return;
+    }
+    ofstream arquivo(caminho, ios::binary | ios::trunc);
+    arquivo << json;
+    if (!arquivo) {
+        throw runtime_error("cannot write " + caminho);
+    }
+}
@@ -0,0 +1,47 @@
+#include "MemoriaPlanos.h"
+
+using namespace std;
+
+MemoriaPlanos::MemoriaPlanos(size_t capacidade) : capacidade(max<size_t>(capacidade, 1)) {}
+
+optional<uint64_t> MemoriaPlanos::chave(const string& cpf1, const string& cpf2) {
+    Simbolo s1 = Simbolo::buscar(cpf1);
+    Simbolo s2 = Simbolo::buscar(cpf2);
+    if (!s1.valido() || !s2.valido()) {
+        return nullopt;
+    }
+    return Registro::chaveCasal(s1, s2);
+}
+
+shared_ptr<const PlanoCasal> MemoriaPlanos::planejar(const Registro& registro, const string& cpf1,
+                                                     const string& cpf2) {
+    optional<uint64_t> k = chave(cpf1, cpf2);
+    if (k) {
+        lock_guard<mutex> trava(acesso);
+        auto it = porChave.find(*k);
+        if (it != porChave.end()) {
+            recentes.splice(recentes.begin(), recentes, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Planned outside the lock so other queries are not held up
+    auto plano = make_shared<const PlanoCasal>(planejarCasal(registro, cpf1, cpf2));
+    if (!k || !plano->p1 || !plano->p2) {
+        return plano;
+    }
+
+    lock_guard<mutex> trava(acesso);
+    auto it = porChave.find(*k);
+    if (it != porChave.end()) {
+        recentes.splice(recentes.begin(), recentes, it->second);
+        return it->second->second;
+    }
+    recentes.emplace_front(*k, plano);
+    porChave.emplace(*k, recentes.begin());
+    if (recentes.size() > capacidade) {
+        porChave.erase(recentes.back().first);
+        recentes.pop_back();
+    }
+    return plano;
+}
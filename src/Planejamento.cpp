@@ -0,0 +1,270 @@
+#include "Planejamento.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <optional>
+
+#include "Binario.h"
+#include "Instrumentacao.h"
+#include "Intersecao.h"
+#include "Medicao.h"
+#include "Poupanca.h"
+#include "Resumo.h"
+
+using namespace std;
+
+namespace {
+
+// Start month of a row from its date column; a date the table could not
+// parse is parsed again from the text so the same error surfaces
+YearMonth mesDaLinha(int32_t mes, const string& data) {
+    if (mes == MES_INVALIDO) {
+        return parseDateToYearMonth(data);
+    }
+    return YearMonth::fromAbsoluteMonth(mes);
+}
+
+ChavePlano chaveDoPlano(const PessoaFisica* p1, const PessoaFisica* p2, const vector<Expense>& expenses) {
+    string dados;
+    dados.reserve(6 * sizeof(int64_t) + expenses.size() * (2 * sizeof(int32_t) + sizeof(int64_t)));
+    for (const PessoaFisica* p : {p1, p2}) {
+        anexarNumero(dados, p->getDinheiroGuardado().getCentavos());
+        anexarNumero(dados, p->getSalario().getCentavos());
+        anexarNumero(dados, p->getGastosMensais().getCentavos());
+    }
+    for (const Expense& exp : expenses) {
+        anexarNumero(dados, static_cast<int32_t>(exp.start.toAbsoluteMonth()));
+        anexarNumero(dados, exp.total.getCentavos());
+        anexarNumero(dados, static_cast<int32_t>(exp.numParcels));
+    }
+    return {resumo64(dados), resumo64(dados, 0x9e3779b97f4a7c15ULL)};
+}
+
+// Plans the couple up to the savings simulation. When the balances still
+// have to be simulated, sizes plano.saldos, fills variacao with the month
+// ledger and returns the account to simulate into them.
+optional<ContaPoupanca> prepararCasal(const Registro& registro, string_view cpf1, string_view cpf2,
+                                      const CachePlanos* cache, PlanoCasal& plano, vector<Dinheiro>& variacao) {
+    optional<ContaPoupanca> conta;
+
+    const vector<Lar>& lares = registro.getLares();
+    const vector<Tarefa>& tarefas = registro.getTarefas();
+    const vector<Casamento>& casamentos = registro.getCasamentos();
+    const vector<Festa>& festas = registro.getFestas();
+    const TabelaTarefas& tabelaTarefas = registro.getTabelaTarefas();
+    const TabelaCompras& tabelaCompras = registro.getTabelaCompras();
+    const TabelaFestas& tabelaFestas = registro.getTabelaFestas();
+
+    // A CPF that was never interned is not in pessoas.csv either
+    const PessoaFisica* p1 = registro.findPessoaByCpf(Simbolo::buscar(cpf1));
+    const PessoaFisica* p2 = registro.findPessoaByCpf(Simbolo::buscar(cpf2));
+
+    if (!p1 || !p2) {
+        return conta;
+    }
+    plano.p1 = p1;
+    plano.p2 = p2;
+
+    Simbolo nome1 = p1->getNome();
+    Simbolo nome2 = p2->getNome();
+
+    Simbolo id1 = p1->getId();
+    Simbolo id2 = p2->getId();
+
+    vector<Expense> expenses;
+
+    // Rows owned by the couple, gathered from the registry indexes and
+    // kept in file order so expenses add up in the same order as before
+    vector<size_t> idxTarefas;
+    for (size_t l : registro.getLaresDoCasal(id1, id2)) {
+        Simbolo idLar = lares[l].getIdLar();
+        if (registro.findLarById(idLar) == &lares[l]) {
+            const vector<size_t>& doLar = registro.getTarefasDoLar(idLar);
+            idxTarefas.insert(idxTarefas.end(), doLar.begin(), doLar.end());
+        }
+    }
+    sort(idxTarefas.begin(), idxTarefas.end());
+
+    vector<size_t> idxFestas;
+    for (size_t c : registro.getCasamentosDoCasal(id1, id2)) {
+        Simbolo idCas = casamentos[c].getIdCasamento();
+        if (registro.findCasamentoById(idCas) == &casamentos[c]) {
+            const vector<size_t>& doCasamento = registro.getFestasDoCasamento(idCas);
+            idxFestas.insert(idxFestas.end(), doCasamento.begin(), doCasamento.end());
+        }
+    }
+    sort(idxFestas.begin(), idxFestas.end());
+
+    // Each compra paired with the tarefa it belongs to, which gives its start
+    vector<pair<size_t, size_t>> idxCompras;
+    for (size_t t : idxTarefas) {
+        Simbolo idTarefa = tabelaTarefas.idTarefa[t];
+        if (registro.findIndiceTarefaById(idTarefa) == t) {
+            for (size_t c : registro.getComprasDaTarefa(idTarefa)) {
+                idxCompras.emplace_back(c, t);
+            }
+        }
+    }
+    sort(idxCompras.begin(), idxCompras.end());
+
+    expenses.reserve(idxTarefas.size() + idxFestas.size() + idxCompras.size());
+
+    for (size_t t : idxTarefas) {
+        YearMonth start = mesDaLinha(tabelaTarefas.mesInicio[t], tarefas[t].getDataInicio());
+        expenses.emplace_back(start, tabelaTarefas.valorPrestador[t], tabelaTarefas.numParcelas[t]);
+    }
+
+    for (size_t f : idxFestas) {
+        YearMonth start = mesDaLinha(tabelaFestas.mesData[f], festas[f].getData());
+        expenses.emplace_back(start, tabelaFestas.valorPago[f], tabelaFestas.numParcelas[f]);
+    }
+
+    for (auto [c, t] : idxCompras) {
+        YearMonth start = mesDaLinha(tabelaTarefas.mesInicio[t], tarefas[t].getDataInicio());
+        Dinheiro totalCompra = tabelaCompras.precoUnitario[c] * tabelaCompras.qtdeProduto[c];
+        expenses.emplace_back(start, totalCompra, tabelaCompras.numeroParcelas[c]);
+    }
+
+    if (cache) {
+        plano.chave = chaveDoPlano(p1, p2, expenses);
+        plano.doCache = cache->buscar(plano.chave, plano.timeline, plano.saldos);
+    }
+
+    // Dense month ledger: every expense is a range update on a difference
+    // array indexed by absolute month, so an expense costs O(1) whatever its
+    // number of parcels. An expense without parcels is never due.
+    int primeiroMes = numeric_limits<int>::max();
+    int ultimoMes = numeric_limits<int>::min();
+    for (const auto& exp : expenses) {
+        if (exp.numParcels > 0) {
+            primeiroMes = min(primeiroMes, exp.start.toAbsoluteMonth());
+            ultimoMes = max(ultimoMes, exp.start.toAbsoluteMonth() + exp.numParcels - 1);
+        }
+    }
+
+    // With no parcel due anywhere the timeline stays empty
+    if (!plano.doCache && primeiroMes <= ultimoMes) {
+        size_t numMeses = static_cast<size_t>(ultimoMes - primeiroMes + 1);
+        variacao.assign(numMeses + 1, Dinheiro());
+        for (const auto& exp : expenses) {
+            if (exp.numParcels > 0) {
+                size_t inicio = static_cast<size_t>(exp.start.toAbsoluteMonth() - primeiroMes);
+                Dinheiro maior = exp.total.parcela(0, exp.numParcels);
+                Dinheiro menor = exp.total.parcela(exp.numParcels - 1, exp.numParcels);
+                variacao[inicio] += maior;
+                variacao[inicio + exp.total.parcelasMaiores(exp.numParcels)] += menor - maior;
+                variacao[inicio + exp.numParcels] -= menor;
+            }
+        }
+
+        // Create the timeline
+        plano.timeline.reserve(numMeses);
+        for (int mes = primeiroMes; mes <= ultimoMes; mes++) {
+            plano.timeline.push_back(YearMonth::fromAbsoluteMonth(mes));
+        }
+
+        // The savings account, simulated by the caller. The 13th salary is
+        // only paid by a positive salary.
+        plano.saldos.resize(numMeses);
+        conta.emplace();
+        conta->saldoInicial = p1->getDinheiroGuardado() + p2->getDinheiroGuardado();
+        conta->salario = p1->getSalario() + p2->getSalario();
+        conta->decimoTerceiro = max(p1->getSalario(), Dinheiro()) + max(p2->getSalario(), Dinheiro());
+        conta->gastosMensais = p1->getGastosMensais() + p2->getGastosMensais();
+        conta->primeiroMes = primeiroMes;
+        conta->numMeses = numMeses;
+        conta->variacao = variacao.data();
+        conta->saldos = plano.saldos.data();
+    }
+
+    // Calculate total expenses for the casal (an expense split into zero
+    // parcels has no defined value and is left out)
+    plano.totalGasto = accumulate(expenses.begin(), expenses.end(), Dinheiro(),
+                                [](Dinheiro sum, const Expense& e) {
+                                    return e.numParcels != 0 ? sum + e.total : sum;
+                                });
+
+    // Find their wedding (Casamento)
+    Simbolo idCasamento;
+    const vector<size_t>& casamentosDoCasal = registro.getCasamentosDoCasal(id1, id2);
+    if (!casamentosDoCasal.empty()) {
+        idCasamento = casamentos[casamentosDoCasal.front()].getIdCasamento();
+    }
+
+    // If no wedding is found, set a default value
+    if (idCasamento.texto().empty()) {
+        idCasamento = Simbolo::buscar("1"); // Default value
+    }
+
+    // Count shared parties (Festa): the festas both names are invited to,
+    // from the guest index, minus the ones of their own wedding
+    const vector<uint32_t>& festasNome1 = registro.getFestasDoConvidado(nome1);
+    const vector<uint32_t>& festasNome2 = registro.getFestasDoConvidado(nome2);
+    size_t emComum = contarIntersecao(festasNome1.data(), festasNome1.size(),
+                                      festasNome2.data(), festasNome2.size());
+    for (size_t f : registro.getFestasDoCasamento(idCasamento)) {
+        uint32_t posicao = static_cast<uint32_t>(f);
+        if (binary_search(festasNome1.begin(), festasNome1.end(), posicao)
+            && binary_search(festasNome2.begin(), festasNome2.end(), posicao)) {
+            emComum--;
+        }
+    }
+    plano.festasEmComum = static_cast<int>(emComum);
+
+    return conta;
+}
+
+} // namespace
+
+PlanoCasal planejarCasal(const Registro& registro, const string& cpf1, const string& cpf2,
+                         const CachePlanos* cache) {
+    PlanoCasal plano;
+    vector<Dinheiro> variacao;
+    optional<ContaPoupanca> conta = prepararCasal(registro, cpf1, cpf2, cache, plano, variacao);
+    if (conta) {
+        simularPoupancas(&*conta, 1);
+    }
+    return plano;
+}
+
+vector<PlanoCasal> planejarCasais(const Registro& registro, const vector<pair<string_view, string_view>>& pares,
+                                  const CachePlanos* cache, vector<double>* segundosPorCasal) {
+    vector<PlanoCasal> planos(pares.size());
+    vector<vector<Dinheiro>> variacoes(pares.size());
+    vector<ContaPoupanca> contas;
+    vector<size_t> simulados;
+    if (segundosPorCasal) {
+        segundosPorCasal->assign(pares.size(), 0.0);
+    }
+
+    for (size_t i = 0; i < pares.size(); i++) {
+        Cronometro cronometro;
+        Trecho trecho("prepararCasal", "planejamento");
+        optional<ContaPoupanca> conta = prepararCasal(registro, pares[i].first, pares[i].second, cache, planos[i],
+                                                      variacoes[i]);
+        if (conta) {
+            contas.push_back(*conta);
+            simulados.push_back(i);
+        }
+        if (segundosPorCasal) {
+            (*segundosPorCasal)[i] = cronometro.segundos();
+        }
+    }
+
+    Cronometro cronometro;
+    {
+        Trecho trecho("simularPoupancas", "planejamento");
+        trecho.contarItens(contas.size());
+        simularPoupancas(contas.data(), contas.size());
+    }
+
+    // The simulated couples share the time of the joint simulation
+    if (segundosPorCasal && !simulados.empty()) {
+        double parte = cronometro.segundos() / static_cast<double>(simulados.size());
+        for (size_t i : simulados) {
+            (*segundosPorCasal)[i] += parte;
+        }
+    }
+    return planos;
+}
@@ -0,0 +1,265 @@
+#include "Poupanca.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__)
+#define POUPANCA_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t MAX_LANES = 8;
+
+// Balances up to this many cents in absolute value go through the double
+// division exactly; a lane that leaves the range is redone by the scalar loop
+constexpr int64_t LIMITE_LANES = int64_t(1) << 49;
+
+static_assert(sizeof(Dinheiro) == sizeof(int64_t), "kernels read Dinheiro arrays as int64 cents");
+
+// The accounts of a group, one per lane. Unused lanes are all zeros, have
+// no months and only produce zeros.
+struct Grupo {
+    alignas(64) int64_t saldo[MAX_LANES] = {};
+    alignas(64) int64_t salario[MAX_LANES] = {};
+    alignas(64) int64_t decimoTerceiro[MAX_LANES] = {};
+    alignas(64) int64_t gastosMensais[MAX_LANES] = {};
+    alignas(64) int64_t mesNoAno[MAX_LANES] = {}; // 0 = January
+    alignas(64) int64_t numMeses[MAX_LANES] = {};
+    alignas(64) const int64_t* variacao[MAX_LANES] = {};
+    alignas(64) int64_t* saldos[MAX_LANES] = {};
+    size_t maxMeses = 0;
+};
+
+// Runs every lane of the group to its last month and stores the balances.
+// Returns the lanes whose balance left LIMITE_LANES.
+using KernelLanes = uint32_t (*)(const Grupo&);
+
+void simularConta(const ContaPoupanca& conta) {
+    Dinheiro poupanca = conta.saldoInicial;
+    Dinheiro expense;
+    int mesNoAno = conta.primeiroMes % 12;
+    for (size_t m = 0; m < conta.numMeses; m++) {
+        Dinheiro combinedSalary = conta.salario;
+        if (mesNoAno == 11) {
+            combinedSalary += conta.decimoTerceiro;
+        }
+
+        expense += conta.variacao[m];
+
+        // Apply savings interest (0.5% per month, rounded to the cent)
+        poupanca += poupanca.jurosMensais();
+
+        poupanca = poupanca + combinedSalary - expense - conta.gastosMensais;
+        conta.saldos[m] = poupanca;
+
+        mesNoAno = mesNoAno == 11 ? 0 : mesNoAno + 1;
+    }
+}
+
+#ifdef POUPANCA_X86
+
+// The interest is trunc((saldo +/- 100) / 200), the sign following the
+// balance. Within LIMITE_LANES the numerator is exact as a double and the
+// quotient truncates to the same integer as the integer division.
+//
+// AVX2 has no scatter: the ledgers are copied into a month-major buffer,
+// the lanes run over it and the balances are copied back out.
+__attribute__((target("avx2")))
+uint32_t kernelAvx2(const Grupo& grupo) {
+    constexpr size_t LANES = 4;
+    // Adding 1.5 * 2^52 moves an integer below 2^51 into the mantissa, which
+    // converts between int64 and double without AVX-512
+    const __m256d MAGICO = _mm256_set1_pd(6755399441055744.0);
+    const __m256i magicoInteiro = _mm256_castpd_si256(MAGICO);
+    const __m256d duzentos = _mm256_set1_pd(200.0);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i um = _mm256_set1_epi64x(1);
+    const __m256i onze = _mm256_set1_epi64x(11);
+    const __m256i doze = _mm256_set1_epi64x(12);
+    const __m256i cem = _mm256_set1_epi64x(100);
+    const __m256i menosCem = _mm256_set1_epi64x(-100);
+    const __m256i limite = _mm256_set1_epi64x(LIMITE_LANES);
+    const __m256i menosLimite = _mm256_set1_epi64x(-LIMITE_LANES);
+
+    vector<int64_t> meses(grupo.maxMeses * LANES, 0);
+    for (size_t l = 0; l < LANES; l++) {
+        for (int64_t m = 0; m < grupo.numMeses[l]; m++) {
+            meses[static_cast<size_t>(m) * LANES + l] = grupo.variacao[l][m];
+        }
+    }
+
+    __m256i saldo = _mm256_load_si256(reinterpret_cast<const __m256i*>(grupo.saldo));
+    __m256i salario = _mm256_load_si256(reinterpret_cast<const __m256i*>(grupo.salario));
+    __m256i decimo = _mm256_load_si256(reinterpret_cast<const __m256i*>(grupo.decimoTerceiro));
+    __m256i gastos = _mm256_load_si256(reinterpret_cast<const __m256i*>(grupo.gastosMensais));
+    __m256i mes = _mm256_load_si256(reinterpret_cast<const __m256i*>(grupo.mesNoAno));
+    __m256i restantes = _mm256_load_si256(reinterpret_cast<const __m256i*>(grupo.numMeses));
+    __m256i despesa = zero;
+    __m256i fora = zero;
+
+    for (size_t m = 0; m < grupo.maxMeses; m++) {
+        // Months past the end of a lane's account are computed and dropped
+        __m256i ativa = _mm256_cmpgt_epi64(restantes, zero);
+        __m256i foraDoLimite = _mm256_or_si256(_mm256_cmpgt_epi64(saldo, limite), _mm256_cmpgt_epi64(menosLimite, saldo));
+        fora = _mm256_or_si256(fora, _mm256_and_si256(ativa, foraDoLimite));
+
+        __m256i negativo = _mm256_cmpgt_epi64(zero, saldo);
+        __m256i numerador = _mm256_add_epi64(saldo, _mm256_blendv_epi8(cem, menosCem, negativo));
+        __m256d real = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(numerador, magicoInteiro)), MAGICO);
+        __m256d quociente = _mm256_round_pd(_mm256_div_pd(real, duzentos), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256i juros = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(quociente, MAGICO)), magicoInteiro);
+
+        __m256i variacao = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(meses.data() + m * LANES));
+        despesa = _mm256_add_epi64(despesa, variacao);
+        __m256i entrada = _mm256_add_epi64(salario, _mm256_and_si256(_mm256_cmpeq_epi64(mes, onze), decimo));
+
+        saldo = _mm256_add_epi64(saldo, juros);
+        saldo = _mm256_sub_epi64(_mm256_add_epi64(saldo, entrada), _mm256_add_epi64(despesa, gastos));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(meses.data() + m * LANES), saldo);
+
+        restantes = _mm256_sub_epi64(restantes, um);
+        mes = _mm256_add_epi64(mes, um);
+        mes = _mm256_andnot_si256(_mm256_cmpeq_epi64(mes, doze), mes);
+    }
+
+    for (size_t l = 0; l < LANES; l++) {
+        for (int64_t m = 0; m < grupo.numMeses[l]; m++) {
+            grupo.saldos[l][m] = meses[static_cast<size_t>(m) * LANES + l];
+        }
+    }
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(fora)));
+}
+
+// Same steps on 8 lanes, with the native int64/double conversions. Each
+// lane gathers its ledger and scatters its balances in place, masked off
+// once its account has no months left.
+__attribute__((target("avx512f,avx512dq")))
+uint32_t kernelAvx512(const Grupo& grupo) {
+    const __m512d duzentos = _mm512_set1_pd(200.0);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i um = _mm512_set1_epi64(1);
+    const __m512i oito = _mm512_set1_epi64(8);
+    const __m512i onze = _mm512_set1_epi64(11);
+    const __m512i doze = _mm512_set1_epi64(12);
+    const __m512i cem = _mm512_set1_epi64(100);
+    const __m512i menosCem = _mm512_set1_epi64(-100);
+    const __m512i limite = _mm512_set1_epi64(LIMITE_LANES);
+    const __m512i menosLimite = _mm512_set1_epi64(-LIMITE_LANES);
+
+    __m512i saldo = _mm512_load_si512(grupo.saldo);
+    __m512i salario = _mm512_load_si512(grupo.salario);
+    __m512i decimo = _mm512_load_si512(grupo.decimoTerceiro);
+    __m512i gastos = _mm512_load_si512(grupo.gastosMensais);
+    __m512i mes = _mm512_load_si512(grupo.mesNoAno);
+    __m512i restantes = _mm512_load_si512(grupo.numMeses);
+    __m512i origem = _mm512_load_si512(grupo.variacao);
+    __m512i destino = _mm512_load_si512(grupo.saldos);
+    __m512i despesa = zero;
+    __mmask8 fora = 0;
+
+    for (size_t m = 0; m < grupo.maxMeses; m++) {
+        __mmask8 ativa = _mm512_cmpgt_epi64_mask(restantes, zero);
+        fora |= _mm512_mask_cmpgt_epi64_mask(ativa, saldo, limite) | _mm512_mask_cmpgt_epi64_mask(ativa, menosLimite, saldo);
+
+        __mmask8 negativo = _mm512_cmpgt_epi64_mask(zero, saldo);
+        __m512i numerador = _mm512_add_epi64(saldo, _mm512_mask_blend_epi64(negativo, cem, menosCem));
+        __m512i juros = _mm512_cvttpd_epi64(_mm512_div_pd(_mm512_cvtepi64_pd(numerador), duzentos));
+
+        __m512i variacao = _mm512_mask_i64gather_epi64(zero, ativa, origem, nullptr, 1);
+        despesa = _mm512_add_epi64(despesa, variacao);
+        __m512i entrada = _mm512_mask_add_epi64(salario, _mm512_cmpeq_epi64_mask(mes, onze), salario, decimo);
+
+        saldo = _mm512_add_epi64(saldo, juros);
+        saldo = _mm512_sub_epi64(_mm512_add_epi64(saldo, entrada), _mm512_add_epi64(despesa, gastos));
+        _mm512_mask_i64scatter_epi64(nullptr, ativa, destino, saldo, 1);
+
+        origem = _mm512_add_epi64(origem, oito);
+        destino = _mm512_add_epi64(destino, oito);
+        restantes = _mm512_sub_epi64(restantes, um);
+        mes = _mm512_add_epi64(mes, um);
+        mes = _mm512_mask_mov_epi64(mes, _mm512_cmpeq_epi64_mask(mes, doze), zero);
+    }
+    return fora;
+}
+
+#endif
+
+// Runs the accounts in groups of `lanes`, longest first so the accounts of a
+// group have similar lengths and few lanes sit idle
+void simularEmLanes(const ContaPoupanca* contas, size_t numContas, size_t lanes, KernelLanes kernel) {
+    vector<size_t> ordem(numContas);
+    iota(ordem.begin(), ordem.end(), size_t(0));
+    stable_sort(ordem.begin(), ordem.end(),
+                [&](size_t a, size_t b) { return contas[a].numMeses > contas[b].numMeses; });
+
+    for (size_t inicio = 0; inicio < numContas; inicio += lanes) {
+        size_t numLanes = min(lanes, numContas - inicio);
+
+        Grupo grupo;
+        grupo.maxMeses = contas[ordem[inicio]].numMeses;
+        if (grupo.maxMeses == 0) {
+            break;
+        }
+        for (size_t l = 0; l < numLanes; l++) {
+            const ContaPoupanca& conta = contas[ordem[inicio + l]];
+            grupo.saldo[l] = conta.saldoInicial.getCentavos();
+            grupo.salario[l] = conta.salario.getCentavos();
+            grupo.decimoTerceiro[l] = conta.decimoTerceiro.getCentavos();
+            grupo.gastosMensais[l] = conta.gastosMensais.getCentavos();
+            grupo.mesNoAno[l] = conta.primeiroMes % 12;
+            grupo.numMeses[l] = static_cast<int64_t>(conta.numMeses);
+            grupo.variacao[l] = reinterpret_cast<const int64_t*>(conta.variacao);
+            grupo.saldos[l] = reinterpret_cast<int64_t*>(conta.saldos);
+        }
+
+        uint32_t fora = kernel(grupo);
+        for (size_t l = 0; l < numLanes; l++) {
+            if (fora & (1u << l)) {
+                simularConta(contas[ordem[inicio + l]]);
+            }
+        }
+    }
+}
+
+struct Simulador {
+    size_t lanes = 1;
+    KernelLanes kernel = nullptr;
+};
+
+Simulador escolherSimulador() {
+#ifdef POUPANCA_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return {8, kernelAvx512};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {4, kernelAvx2};
+    }
+#endif
+    return {};
+}
+
+} // namespace
+
+void simularPoupancasEscalar(const ContaPoupanca* contas, size_t numContas) {
+    for (size_t i = 0; i < numContas; i++) {
+        simularConta(contas[i]);
+    }
+}
+
+void simularPoupancas(const ContaPoupanca* contas, size_t numContas) {
+    static const Simulador simulador = escolherSimulador();
+
+    // A lone account would leave every other lane idle
+    if (!simulador.kernel || numContas < 2) {
+        simularPoupancasEscalar(contas, numContas);
+        return;
+    }
+    simularEmLanes(contas, numContas, simulador.lanes, simulador.kernel);
+}
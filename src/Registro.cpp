@@ -0,0 +1,170 @@
+#include "Registro.h"
+
+#include "Instrumentacao.h"
+
+using namespace std;
+
+namespace {
+
+const vector<size_t> nenhum;
+const vector<uint32_t> nenhumaFesta;
+
+template <typename Mapa>
+const vector<size_t>& buscarLista(const Mapa& mapa, typename Mapa::key_type chave) {
+    contarBusca();
+    auto it = mapa.find(chave);
+    return it != mapa.end() ? it->second : nenhum;
+}
+
+} // namespace
+
+Registro::Registro(const vector<Pessoa*>& pessoas, const vector<Lar>& lares,
+                   const vector<Tarefa>& tarefas, const vector<Casamento>& casamentos,
+                   const vector<Festa>& festas, const vector<Compra>& compras)
+    : pessoas(pessoas), lares(lares), tarefas(tarefas), casamentos(casamentos),
+      festas(festas), compras(compras),
+      tabelaTarefas(tarefas), tabelaCompras(compras), tabelaFestas(festas) {
+
+    pessoaPorId.reserve(pessoas.size());
+    for (size_t i = 0; i < pessoas.size(); i++) {
+        Pessoa* p = pessoas[i];
+        pessoaPorId.try_emplace(p->getId(), i);
+
+        if (p->isPessoaFisica()) {
+            pessoaPorCpf.try_emplace(static_cast<PessoaFisica*>(p)->getCpf(), i);
+        } else if (p->isPessoaJuridica()) {
+            pessoaPorCnpj.try_emplace(static_cast<PessoaJuridica*>(p)->getCnpj(), i);
+        } else if (p->isLoja()) {
+            pessoaPorCnpj.try_emplace(static_cast<Loja*>(p)->getCnpj(), i);
+        }
+    }
+
+    larPorId.reserve(lares.size());
+    for (size_t i = 0; i < lares.size(); i++) {
+        larPorId.try_emplace(lares[i].getIdLar(), i);
+        laresPorCasal[chaveCasal(lares[i].getId1(), lares[i].getId2())].push_back(i);
+    }
+
+    tarefaPorId.reserve(tarefas.size());
+    for (size_t i = 0; i < tarefas.size(); i++) {
+        tarefaPorId.try_emplace(tarefas[i].getIdTarefa(), i);
+        tarefasPorLar[tarefas[i].getIdLar()].push_back(i);
+    }
+
+    casamentoPorId.reserve(casamentos.size());
+    for (size_t i = 0; i < casamentos.size(); i++) {
+        casamentoPorId.try_emplace(casamentos[i].getIdCasamento(), i);
+        casamentosPorCasal[chaveCasal(casamentos[i].getId1(), casamentos[i].getId2())].push_back(i);
+    }
+
+    festaPorId.reserve(festas.size());
+    for (size_t i = 0; i < festas.size(); i++) {
+        festaPorId.try_emplace(festas[i].getId(), i);
+        festasPorCasamento[festas[i].getIdCasamento()].push_back(i);
+
+        for (Simbolo convidado : festas[i].getConvidados()) {
+            vector<uint32_t>& doConvidado = festasPorConvidado[convidado];
+            if (doConvidado.empty() || doConvidado.back() != i) {
+                doConvidado.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    compraPorId.reserve(compras.size());
+    for (size_t i = 0; i < compras.size(); i++) {
+        compraPorId.try_emplace(compras[i].getId(), i);
+        comprasPorTarefa[compras[i].getIdTarefa()].push_back(i);
+    }
+}
+
+uint64_t Registro::chaveCasal(Simbolo id1, Simbolo id2) {
+    uint64_t a = id1.getHandle();
+    uint64_t b = id2.getHandle();
+    return a < b ? (a << 32) | b : (b << 32) | a;
+}
+
+Pessoa* Registro::findPessoaById(Simbolo id) const {
+    contarBusca();
+    auto it = pessoaPorId.find(id);
+    return it != pessoaPorId.end() ? pessoas[it->second] : nullptr;
+}
+
+size_t Registro::findIndicePessoaById(Simbolo id) const {
+    contarBusca();
+    auto it = pessoaPorId.find(id);
+    return it != pessoaPorId.end() ? it->second : NAO_ENCONTRADO;
+}
+
+PessoaFisica* Registro::findPessoaByCpf(Simbolo cpf) const {
+    contarBusca();
+    auto it = pessoaPorCpf.find(cpf);
+    return it != pessoaPorCpf.end() ? static_cast<PessoaFisica*>(pessoas[it->second]) : nullptr;
+}
+
+Pessoa* Registro::findPessoaByCnpj(Simbolo cnpj) const {
+    contarBusca();
+    auto it = pessoaPorCnpj.find(cnpj);
+    return it != pessoaPorCnpj.end() ? pessoas[it->second] : nullptr;
+}
+
+const Lar* Registro::findLarById(Simbolo idLar) const {
+    contarBusca();
+    auto it = larPorId.find(idLar);
+    return it != larPorId.end() ? &lares[it->second] : nullptr;
+}
+
+const Tarefa* Registro::findTarefaById(Simbolo idTarefa) const {
+    contarBusca();
+    auto it = tarefaPorId.find(idTarefa);
+    return it != tarefaPorId.end() ? &tarefas[it->second] : nullptr;
+}
+
+size_t Registro::findIndiceTarefaById(Simbolo idTarefa) const {
+    contarBusca();
+    auto it = tarefaPorId.find(idTarefa);
+    return it != tarefaPorId.end() ? it->second : NAO_ENCONTRADO;
+}
+
+const Casamento* Registro::findCasamentoById(Simbolo idCasamento) const {
+    contarBusca();
+    auto it = casamentoPorId.find(idCasamento);
+    return it != casamentoPorId.end() ? &casamentos[it->second] : nullptr;
+}
+
+const Festa* Registro::findFestaById(Simbolo id) const {
+    contarBusca();
+    auto it = festaPorId.find(id);
+    return it != festaPorId.end() ? &festas[it->second] : nullptr;
+}
+
+const Compra* Registro::findCompraById(Simbolo id) const {
+    contarBusca();
+    auto it = compraPorId.find(id);
+    return it != compraPorId.end() ? &compras[it->second] : nullptr;
+}
+
+const vector<size_t>& Registro::getTarefasDoLar(Simbolo idLar) const {
+    return buscarLista(tarefasPorLar, idLar);
+}
+
+const vector<size_t>& Registro::getComprasDaTarefa(Simbolo idTarefa) const {
+    return buscarLista(comprasPorTarefa, idTarefa);
+}
+
+const vector<size_t>& Registro::getFestasDoCasamento(Simbolo idCasamento) const {
+    return buscarLista(festasPorCasamento, idCasamento);
+}
+
+const vector<size_t>& Registro::getLaresDoCasal(Simbolo id1, Simbolo id2) const {
+    return buscarLista(laresPorCasal, chaveCasal(id1, id2));
+}
+
+const vector<size_t>& Registro::getCasamentosDoCasal(Simbolo id1, Simbolo id2) const {
+    return buscarLista(casamentosPorCasal, chaveCasal(id1, id2));
+}
+
+const vector<uint32_t>& Registro::getFestasDoConvidado(Simbolo nome) const {
+    contarBusca();
+    auto it = festasPorConvidado.find(nome);
+    return it != festasPorConvidado.end() ? it->second : nenhumaFesta;
+}
@@ -0,0 +1,36 @@
+#include "Resumo.h"
+
+#include <cstring>
+
+using namespace std;
+
+uint64_t resumo64(string_view dados, uint64_t semente) {
+    constexpr uint64_t M = 0xc6a4a7935bd1e995ULL;
+    constexpr int R = 47;
+
+    const char* p = dados.data();
+    size_t tamanho = dados.size();
+    uint64_t h = semente ^ (tamanho * M);
+
+    for (; tamanho >= 8; p += 8, tamanho -= 8) {
+        uint64_t k;
+        memcpy(&k, p, 8);
+        k *= M;
+        k ^= k >> R;
+        k *= M;
+        h ^= k;
+        h *= M;
+    }
+
+    if (tamanho > 0) {
+        uint64_t resto = 0;
+        memcpy(&resto, p, tamanho);
+        h ^= resto;
+        h *= M;
+    }
+
+    h ^= h >> R;
+    h *= M;
+    h ^= h >> R;
+    return h;
+}
@@ -0,0 +1,292 @@
+#include "Servidor.h"
+
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Formatacao.h"
+#include "Json.h"
+
+using namespace std;
+
+namespace {
+
+// A line longer than this is not a request; the connection is dropped
+constexpr size_t TAMANHO_MAX_REQUISICAO = 1 << 20;
+
+// How often the accept loop looks at the stop flag, in milliseconds
+constexpr int INTERVALO_PARADA_MS = 200;
+
+atomic<bool> parar{false};
+
+void pedirParada(int) {
+    parar = true;
+}
+
+string respostaErro(string_view mensagem) {
+    string resposta = "{\"ok\":false,\"erro\":";
+    anexarTextoJson(resposta, mensagem);
+    resposta += '}';
+    return resposta;
+}
+
+bool enviarTudo(int conexao, string_view dados) {
+    while (!dados.empty()) {
+        ssize_t enviados = send(conexao, dados.data(), dados.size(), MSG_NOSIGNAL);
+        if (enviados < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        dados.remove_prefix(static_cast<size_t>(enviados));
+    }
+    return true;
+}
+
+} // namespace
+
+Servidor::Servidor(const Registro& registro, vector<ReceitaPrestador> prestadores)
+    : registro(registro), prestadores(move(prestadores)), memoria(CAPACIDADE_MEMORIA) {}
+
+string Servidor::responderCasal(const string& cpf1, const string& cpf2, bool comSaldos) const {
+    shared_ptr<const PlanoCasal> memorizado = memoria.planejar(registro, cpf1, cpf2);
+    const PlanoCasal& plano = *memorizado;
+    if (!plano.p1 || !plano.p2) {
+        return respostaErro("Casal não está cadastrado.");
+    }
+
+    // Names in the order the reports use
+    const string& nome1 = plano.p1->getNome().texto();
+    const string& nome2 = plano.p2->getNome().texto();
+    bool trocar = nome2 < nome1;
+
+    string resposta = "{\"ok\":true,\"nome1\":";
+    anexarTextoJson(resposta, trocar ? nome2 : nome1);
+    resposta += ",\"nome2\":";
+    anexarTextoJson(resposta, trocar ? nome1 : nome2);
+    resposta += ",\"totalGasto\":";
+    anexarInteiroJson(resposta, plano.totalGasto.getCentavos());
+    resposta += ",\"festasEmComum\":";
+    anexarInteiroJson(resposta, plano.festasEmComum);
+
+    if (comSaldos) {
+        resposta += ",\"meses\":[";
+        char mesAno[TAMANHO_MAX_MES_ANO];
+        for (size_t m = 0; m < plano.timeline.size(); m++) {
+            if (m > 0) {
+                resposta += ',';
+            }
+            char* fim = formatarMesAno(mesAno, plano.timeline[m]);
+            anexarTextoJson(resposta, string_view(mesAno, static_cast<size_t>(fim - mesAno)));
+        }
+        resposta += "],\"saldos\":[";
+        for (size_t m = 0; m < plano.saldos.size(); m++) {
+            if (m > 0) {
+                resposta += ',';
+            }
+            anexarInteiroJson(resposta, plano.saldos[m].getCentavos());
+        }
+        resposta += ']';
+    }
+
+    resposta += '}';
+    return resposta;
+}
+
+string Servidor::responderPrestadores(size_t limite) const {
+    string resposta = "{\"ok\":true,\"prestadores\":[";
+    size_t total = min(limite, prestadores.size());
+    for (size_t i = 0; i < total; i++) {
+        const Pessoa* p = prestadores[i].pessoa;
+        if (i > 0) {
+            resposta += ',';
+        }
+        resposta += "{\"tipo\":";
+        anexarTextoJson(resposta, p->isPessoaFisica() ? "PF" : p->isLoja() ? "Loja" : "PJ");
+        resposta += ",\"nome\":";
+        anexarTextoJson(resposta, p->getNome().texto());
+        resposta += ",\"valor\":";
+        anexarInteiroJson(resposta, prestadores[i].valor.getCentavos());
+        resposta += '}';
+    }
+    resposta += "]}";
+    return resposta;
+}
+
+string Servidor::responder(string_view requisicao) const {
+    optional<ObjetoJson> objeto = lerObjetoJson(requisicao);
+    if (!objeto) {
+        return respostaErro("JSON inválido");
+    }
+
+    auto campo = [&](const char* nome) -> const string* {
+        auto it = objeto->find(nome);
+        return it != objeto->end() ? &it->second : nullptr;
+    };
+
+    const string* op = campo("op");
+    if (!op) {
+        return respostaErro("Campo op ausente");
+    }
+
+    if (*op == "planejamento" || *op == "casal") {
+        const string* cpf1 = campo("cpf1");
+        const string* cpf2 = campo("cpf2");
+        if (!cpf1 || !cpf2 || cpf1->empty() || cpf2->empty()) {
+            return respostaErro("Campos cpf1 e cpf2 são obrigatórios");
+        }
+        return responderCasal(*cpf1, *cpf2, *op == "planejamento");
+    }
+
+    if (*op == "prestadores") {
+        size_t limite = prestadores.size();
+        if (const string* texto = campo("limite")) {
+            const char* fim = texto->data() + texto->size();
+            auto [ptr, erro] = from_chars(texto->data(), fim, limite);
+            if (erro != errc() || ptr != fim) {
+                return respostaErro("Campo limite inválido");
+            }
+        }
+        return responderPrestadores(limite);
+    }
+
+    return respostaErro("Operação desconhecida: " + *op);
+}
+
+void Servidor::atender(int conexao) const {
+    string pendente;
+    char bloco[64 * 1024];
+
+    while (true) {
+        ssize_t lidos = recv(conexao, bloco, sizeof(bloco), 0);
+        if (lidos < 0 && errno == EINTR) {
+            continue;
+        }
+        if (lidos <= 0) {
+            return;
+        }
+        pendente.append(bloco, static_cast<size_t>(lidos));
+
+        size_t inicio = 0;
+        size_t fim;
+        string respostas;
+        while ((fim = pendente.find('\n', inicio)) != string::npos) {
+            string_view linha(pendente.data() + inicio, fim - inicio);
+            if (!linha.empty() && linha.back() == '\r') {
+                linha.remove_suffix(1);
+            }
+            if (!linha.empty()) {
+                respostas += responder(linha);
+                respostas += '\n';
+            }
+            inicio = fim + 1;
+        }
+        pendente.erase(0, inicio);
+
+        if (!enviarTudo(conexao, respostas)) {
+            return;
+        }
+        if (pendente.size() > TAMANHO_MAX_REQUISICAO) {
+            enviarTudo(conexao, respostaErro("Requisição grande demais") + "\n");
+            return;
+        }
+    }
+}
+
+bool Servidor::executar(const string& caminhoSocket) const {
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (caminhoSocket.size() >= sizeof(endereco.sun_path)) {
+        cerr << "Socket path too long: " << caminhoSocket << endl;
+        return false;
+    }
+    memcpy(endereco.sun_path, caminhoSocket.c_str(), caminhoSocket.size() + 1);
+
+    int escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (escuta < 0) {
+        cerr << "Cannot create socket: " << strerror(errno) << endl;
+        return false;
+    }
+
+    // A socket left behind by an earlier server is replaced
+    struct stat info;
+    if (lstat(caminhoSocket.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(caminhoSocket.c_str());
+    }
+
+    if (bind(escuta, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) != 0 || listen(escuta, SOMAXCONN) != 0) {
+        cerr << "Cannot listen on " << caminhoSocket << ": " << strerror(errno) << endl;
+        close(escuta);
+        return false;
+    }
+
+    parar = false;
+    struct sigaction acao{};
+    acao.sa_handler = pedirParada;
+    sigemptyset(&acao.sa_mask);
+    sigaction(SIGINT, &acao, nullptr);
+    sigaction(SIGTERM, &acao, nullptr);
+
+    struct Conexao {
+        int fd;
+        thread atendente;
+        atomic<bool> terminou{false};
+    };
+    list<Conexao> conexoes;
+
+    while (!parar) {
+        // Threads of closed connections are joined as the loop goes
+        for (auto it = conexoes.begin(); it != conexoes.end();) {
+            if (it->terminou) {
+                it->atendente.join();
+                close(it->fd);
+                it = conexoes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        pollfd espera{escuta, POLLIN, 0};
+        int prontos = poll(&espera, 1, INTERVALO_PARADA_MS);
+        if (prontos <= 0) {
+            continue;
+        }
+
+        int conexao = accept4(escuta, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conexao < 0) {
+            continue;
+        }
+
+        Conexao& nova = conexoes.emplace_back();
+        nova.fd = conexao;
+        nova.atendente = thread([this, &nova]() {
+            atender(nova.fd);
+            nova.terminou = true;
+        });
+    }
+
+    close(escuta);
+    unlink(caminhoSocket.c_str());
+
+    // Wake every client thread blocked in recv and wait for it
+    for (Conexao& conexao : conexoes) {
+        shutdown(conexao.fd, SHUT_RDWR);
+    }
+    for (Conexao& conexao : conexoes) {
+        conexao.atendente.join();
+        close(conexao.fd);
+    }
+    return true;
+}
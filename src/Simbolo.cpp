@@ -0,0 +1,127 @@
+#include "Simbolo.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+// Process-wide intern table. The text → handle maps are split in shards with
+// their own lock, so loader threads interning different IDs rarely meet.
+// Texts live in fixed-size segments that never move, so handle → text reads
+// need no lock and the maps can key on views of the stored strings.
+class TabelaSimbolos {
+private:
+    static constexpr size_t BITS_SEGMENTO = 16;
+    static constexpr size_t TAMANHO_SEGMENTO = size_t(1) << BITS_SEGMENTO;
+    static constexpr size_t MAX_SEGMENTOS = (size_t(1) << 32) / TAMANHO_SEGMENTO;
+    static constexpr size_t NUM_FRAGMENTOS = 64;
+
+    struct Fragmento {
+        shared_mutex trava;
+        unordered_map<string_view, uint32_t> handles;
+    };
+
+    Fragmento fragmentos[NUM_FRAGMENTOS];
+    atomic<string*> segmentos[MAX_SEGMENTOS] = {};
+    atomic<uint32_t> proximo{0};
+
+    Fragmento& fragmentoDe(string_view texto) {
+        return fragmentos[(hash<string_view>{}(texto) >> 16) % NUM_FRAGMENTOS];
+    }
+
+    string& posicao(uint32_t handle) {
+        atomic<string*>& segmento = segmentos[handle >> BITS_SEGMENTO];
+        string* textos = segmento.load(memory_order_acquire);
+        if (!textos) {
+            string* novo = new string[TAMANHO_SEGMENTO];
+            if (segmento.compare_exchange_strong(textos, novo, memory_order_acq_rel)) {
+                textos = novo;
+            } else {
+                delete[] novo; // Another thread opened the segment first
+            }
+        }
+        return textos[handle & (TAMANHO_SEGMENTO - 1)];
+    }
+
+public:
+    TabelaSimbolos() = default;
+    TabelaSimbolos(const TabelaSimbolos&) = delete;
+    TabelaSimbolos& operator=(const TabelaSimbolos&) = delete;
+
+    ~TabelaSimbolos() {
+        for (atomic<string*>& segmento : segmentos) {
+            delete[] segmento.load();
+        }
+    }
+
+    uint32_t internar(string_view texto) {
+        Fragmento& fragmento = fragmentoDe(texto);
+        {
+            shared_lock<shared_mutex> lock(fragmento.trava);
+            auto it = fragmento.handles.find(texto);
+            if (it != fragmento.handles.end()) {
+                return it->second;
+            }
+        }
+
+        unique_lock<shared_mutex> lock(fragmento.trava);
+        auto it = fragmento.handles.find(texto);
+        if (it != fragmento.handles.end()) {
+            return it->second;
+        }
+
+        uint32_t handle = proximo.fetch_add(1, memory_order_relaxed);
+        if (handle == Simbolo::NENHUM) {
+            throw length_error("TabelaSimbolos");
+        }
+        string& guardado = posicao(handle);
+        guardado.assign(texto);
+        fragmento.handles.emplace(string_view(guardado), handle);
+        return handle;
+    }
+
+    uint32_t buscar(string_view texto) {
+        Fragmento& fragmento = fragmentoDe(texto);
+        shared_lock<shared_mutex> lock(fragmento.trava);
+        auto it = fragmento.handles.find(texto);
+        return it != fragmento.handles.end() ? it->second : Simbolo::NENHUM;
+    }
+
+    uint32_t total() const {
+        return proximo.load(memory_order_relaxed);
+    }
+
+    const string& texto(uint32_t handle) const {
+        return segmentos[handle >> BITS_SEGMENTO].load(memory_order_acquire)[handle & (TAMANHO_SEGMENTO - 1)];
+    }
+};
+
+TabelaSimbolos& tabela() {
+    static TabelaSimbolos instancia;
+    return instancia;
+}
+
+const string vazio;
+
+} // namespace
+
+Simbolo Simbolo::de(string_view texto) {
+    return Simbolo(tabela().internar(texto));
+}
+
+Simbolo Simbolo::buscar(string_view texto) {
+    return Simbolo(tabela().buscar(texto));
+}
+
+uint32_t Simbolo::totalInternados() {
+    return tabela().total();
+}
+
+const string& Simbolo::texto() const {
+    return valido() ? tabela().texto(handle) : vazio;
+}
@@ -0,0 +1,483 @@
+#include "Snapshot.h"
+
+#include <filesystem>
+#include <system_error>
+#include <unordered_map>
+
+#include "Binario.h"
+#include "CargaParalela.h"
+#include "Resumo.h"
+
+using namespace std;
+namespace fs = filesystem;
+
+namespace {
+
+constexpr char MAGICO[8] = {'C', 'A', 'S', 'A', 'M', 'S', 'N', 'P'};
+
+constexpr uint8_t TAG_FISICA = 0;
+constexpr uint8_t TAG_JURIDICA = 1;
+constexpr uint8_t TAG_LOJA = 2;
+
+// Builds one section: rows refer to texts by their position in the
+// section's own table, which is written ahead of the rows
+class GravadorSecao {
+private:
+    string simbolos;
+    uint32_t numSimbolos = 0;
+    unordered_map<uint32_t, uint32_t> locais;
+    string linhas;
+    uint64_t numLinhas = 0;
+
+public:
+    template <typename T>
+    void numero(T valor) { anexarNumero(linhas, valor); }
+
+    void texto(string_view valor) { anexarTexto(linhas, valor); }
+
+    void dinheiro(Dinheiro valor) { numero(valor.getCentavos()); }
+
+    void simbolo(Simbolo valor) {
+        auto [it, novo] = locais.try_emplace(valor.getHandle(), numSimbolos);
+        if (novo) {
+            anexarTexto(simbolos, valor.texto());
+            numSimbolos++;
+        }
+        numero(it->second);
+    }
+
+    void proximaLinha() { numLinhas++; }
+
+    string concluir() const {
+        string secao;
+        secao.reserve(sizeof(uint32_t) + simbolos.size() + sizeof(uint64_t) + linhas.size());
+        anexarNumero(secao, numSimbolos);
+        secao.append(simbolos);
+        anexarNumero(secao, numLinhas);
+        secao.append(linhas);
+        return secao;
+    }
+};
+
+// Reads a section written by GravadorSecao, interning its text table once
+class LeitorSecao {
+private:
+    LeitorBinario leitor;
+    vector<Simbolo> simbolos;
+    uint64_t numLinhas;
+
+public:
+    explicit LeitorSecao(string_view conteudo) : leitor(conteudo) {
+        uint32_t numSimbolos = leitor.numero<uint32_t>();
+        simbolos.reserve(numSimbolos);
+        for (uint32_t i = 0; i < numSimbolos; i++) {
+            simbolos.push_back(Simbolo::de(leitor.texto()));
+        }
+        numLinhas = leitor.numero<uint64_t>();
+    }
+
+    uint64_t getNumLinhas() const { return numLinhas; }
+
+    template <typename T>
+    T numero() { return leitor.numero<T>(); }
+
+    string texto() { return string(leitor.texto()); }
+
+    Dinheiro dinheiro() { return Dinheiro::deCentavos(leitor.numero<int64_t>()); }
+
+    Simbolo simbolo() {
+        uint32_t local = leitor.numero<uint32_t>();
+        if (local >= simbolos.size()) {
+            throw DadosBinariosInvalidos();
+        }
+        return simbolos[local];
+    }
+
+    // Every row consumed and nothing left over
+    void verificarFim() const {
+        if (!leitor.fim()) {
+            throw DadosBinariosInvalidos();
+        }
+    }
+};
+
+// Row encodings, one pair per entity type
+
+void gravarLinha(GravadorSecao& g, const Pessoa* p) {
+    if (p->isPessoaFisica()) {
+        g.numero(TAG_FISICA);
+    } else if (p->isPessoaJuridica()) {
+        g.numero(TAG_JURIDICA);
+    } else {
+        g.numero(TAG_LOJA);
+    }
+    g.simbolo(p->getId());
+    g.texto(p->getTipo());
+    g.simbolo(p->getNome());
+    g.texto(p->getTelefone());
+    g.texto(p->getEndereco());
+
+    if (p->isPessoaFisica()) {
+        const PessoaFisica* pf = static_cast<const PessoaFisica*>(p);
+        g.simbolo(pf->getCpf());
+        g.texto(pf->getDataNascimento());
+        g.dinheiro(pf->getDinheiroGuardado());
+        g.dinheiro(pf->getSalario());
+        g.dinheiro(pf->getGastosMensais());
+    } else if (p->isPessoaJuridica()) {
+        g.simbolo(static_cast<const PessoaJuridica*>(p)->getCnpj());
+    } else {
+        g.simbolo(static_cast<const Loja*>(p)->getCnpj());
+    }
+}
+
+void lerLinha(LeitorSecao& l, CadastroPessoas& destino) {
+    uint8_t tag = l.numero<uint8_t>();
+    Simbolo id = l.simbolo();
+    string tipo = l.texto();
+    Simbolo nome = l.simbolo();
+    string telefone = l.texto();
+    string endereco = l.texto();
+
+    if (tag == TAG_FISICA) {
+        Simbolo cpf = l.simbolo();
+        string dataNascimento = l.texto();
+        Dinheiro guardado = l.dinheiro();
+        Dinheiro salario = l.dinheiro();
+        Dinheiro gastos = l.dinheiro();
+        destino.adicionar(PessoaFisica(id, move(tipo), nome, move(telefone), move(endereco), cpf,
+                                       move(dataNascimento), guardado, salario, gastos));
+    } else if (tag == TAG_JURIDICA) {
+        destino.adicionar(PessoaJuridica(id, move(tipo), nome, move(telefone), move(endereco), l.simbolo()));
+    } else if (tag == TAG_LOJA) {
+        destino.adicionar(Loja(id, move(tipo), nome, move(telefone), move(endereco), l.simbolo()));
+    } else {
+        throw DadosBinariosInvalidos();
+    }
+}
+
+void gravarLinha(GravadorSecao& g, const Festa& f) {
+    g.simbolo(f.getId());
+    g.simbolo(f.getIdCasamento());
+    g.texto(f.getLocal());
+    g.texto(f.getData());
+    g.texto(f.getHora());
+    g.dinheiro(f.getValorPago());
+    g.numero(static_cast<int32_t>(f.getNumParcelas()));
+    g.numero(static_cast<uint32_t>(f.getConvidados().size()));
+    for (Simbolo convidado : f.getConvidados()) {
+        g.simbolo(convidado);
+    }
+}
+
+void lerLinha(LeitorSecao& l, vector<Festa>& destino) {
+    Simbolo id = l.simbolo();
+    Simbolo idCasamento = l.simbolo();
+    string local = l.texto();
+    string data = l.texto();
+    string hora = l.texto();
+    Dinheiro valorPago = l.dinheiro();
+    int numParcelas = l.numero<int32_t>();
+    uint32_t numConvidados = l.numero<uint32_t>();
+    vector<Simbolo> convidados;
+    for (uint32_t i = 0; i < numConvidados; i++) {
+        convidados.push_back(l.simbolo());
+    }
+    destino.emplace_back(id, idCasamento, move(local), move(data), move(hora), valorPago, numParcelas,
+                         move(convidados));
+}
+
+void gravarLinha(GravadorSecao& g, const Casamento& c) {
+    g.simbolo(c.getIdCasamento());
+    g.simbolo(c.getId1());
+    g.simbolo(c.getId2());
+    g.texto(c.getData());
+    g.texto(c.getHora());
+    g.texto(c.getLocal());
+}
+
+void lerLinha(LeitorSecao& l, vector<Casamento>& destino) {
+    Simbolo idCasamento = l.simbolo();
+    Simbolo id1 = l.simbolo();
+    Simbolo id2 = l.simbolo();
+    string data = l.texto();
+    string hora = l.texto();
+    string local = l.texto();
+    destino.emplace_back(idCasamento, id1, id2, move(data), move(hora), move(local));
+}
+
+void gravarLinha(GravadorSecao& g, const Lar& lar) {
+    g.simbolo(lar.getIdLar());
+    g.simbolo(lar.getId1());
+    g.simbolo(lar.getId2());
+    g.texto(lar.getRua());
+    g.numero(static_cast<int32_t>(lar.getNumero()));
+    g.texto(lar.getComplemento());
+}
+
+void lerLinha(LeitorSecao& l, vector<Lar>& destino) {
+    Simbolo idLar = l.simbolo();
+    Simbolo id1 = l.simbolo();
+    Simbolo id2 = l.simbolo();
+    string rua = l.texto();
+    int numero = l.numero<int32_t>();
+    string complemento = l.texto();
+    destino.emplace_back(idLar, id1, id2, move(rua), numero, move(complemento));
+}
+
+void gravarLinha(GravadorSecao& g, const Tarefa& t) {
+    g.simbolo(t.getIdTarefa());
+    g.simbolo(t.getIdLar());
+    g.simbolo(t.getIdPrestador());
+    g.texto(t.getDataInicio());
+    g.numero(static_cast<int32_t>(t.getPrazoEntrega()));
+    g.dinheiro(t.getValorPrestador());
+    g.numero(static_cast<int32_t>(t.getNumParcelas()));
+}
+
+void lerLinha(LeitorSecao& l, vector<Tarefa>& destino) {
+    Simbolo idTarefa = l.simbolo();
+    Simbolo idLar = l.simbolo();
+    Simbolo idPrestador = l.simbolo();
+    string dataInicio = l.texto();
+    int prazoEntrega = l.numero<int32_t>();
+    Dinheiro valorPrestador = l.dinheiro();
+    int numParcelas = l.numero<int32_t>();
+    destino.emplace_back(idTarefa, idLar, idPrestador, move(dataInicio), prazoEntrega, valorPrestador, numParcelas);
+}
+
+void gravarLinha(GravadorSecao& g, const Compra& c) {
+    g.simbolo(c.getId());
+    g.simbolo(c.getIdTarefa());
+    g.simbolo(c.getIdLoja());
+    g.texto(c.getNomeProduto());
+    g.numero(static_cast<int32_t>(c.getQtdeProduto()));
+    g.dinheiro(c.getPrecoUnitario());
+    g.numero(static_cast<int32_t>(c.getNumeroParcelas()));
+}
+
+void lerLinha(LeitorSecao& l, vector<Compra>& destino) {
+    Simbolo id = l.simbolo();
+    Simbolo idTarefa = l.simbolo();
+    Simbolo idLoja = l.simbolo();
+    string nomeProduto = l.texto();
+    int qtdeProduto = l.numero<int32_t>();
+    Dinheiro precoUnitario = l.dinheiro();
+    int numeroParcelas = l.numero<int32_t>();
+    destino.emplace_back(id, idTarefa, idLoja, move(nomeProduto), qtdeProduto, precoUnitario, numeroParcelas);
+}
+
+template <typename Linhas>
+string gravarSecao(const Linhas& linhas) {
+    GravadorSecao gravador;
+    for (const auto& linha : linhas) {
+        gravarLinha(gravador, linha);
+        gravador.proximaLinha();
+    }
+    return gravador.concluir();
+}
+
+// Rows go to a scratch destination first, so a damaged section leaves
+// the real one untouched
+template <typename Destino>
+bool lerSecao(string_view conteudo, Destino& destino) {
+    try {
+        LeitorSecao leitor(conteudo);
+        Destino lidos;
+        for (uint64_t i = 0; i < leitor.getNumLinhas(); i++) {
+            lerLinha(leitor, lidos);
+        }
+        leitor.verificarFim();
+
+        vector<Destino> partes;
+        partes.push_back(move(lidos));
+        anexarPartes(destino, partes);
+        return true;
+    } catch (const DadosBinariosInvalidos&) {
+        return false;
+    }
+}
+
+int64_t modificacaoDe(const fs::path& caminho) {
+    return static_cast<int64_t>(fs::last_write_time(caminho).time_since_epoch().count());
+}
+
+} // namespace
+
+Snapshot::Snapshot(const string& caminho) : arquivo(caminho) {
+    if (!arquivo.is_open()) {
+        return;
+    }
+    optional<string_view> corpo = abrirCorpoBinario(arquivo.conteudo(), string_view(MAGICO, sizeof(MAGICO)), VERSAO);
+    if (!corpo) {
+        return;
+    }
+
+    try {
+        LeitorBinario leitor(*corpo);
+        uint32_t numSecoes = leitor.numero<uint32_t>();
+        vector<Secao> lidas;
+        for (uint32_t i = 0; i < numSecoes; i++) {
+            Secao secao;
+            secao.fonte.nome = string(leitor.texto());
+            secao.fonte.tamanho = leitor.numero<uint64_t>();
+            secao.fonte.modificacao = leitor.numero<int64_t>();
+            secao.fonte.resumo = leitor.numero<uint64_t>();
+            uint64_t inicio = leitor.numero<uint64_t>();
+            uint64_t tamanho = leitor.numero<uint64_t>();
+            if (inicio > corpo->size() || tamanho > corpo->size() - inicio) {
+                return;
+            }
+            secao.conteudo = corpo->substr(inicio, tamanho);
+            lidas.push_back(move(secao));
+        }
+
+        vector<vector<string>> mensagens(leitor.numero<uint32_t>());
+        for (vector<string>& daRegra : mensagens) {
+            uint32_t numMensagens = leitor.numero<uint32_t>();
+            for (uint32_t i = 0; i < numMensagens; i++) {
+                daRegra.emplace_back(leitor.texto());
+            }
+        }
+
+        secoes = move(lidas);
+        mensagensPorRegra = move(mensagens);
+    } catch (const DadosBinariosInvalidos&) {
+        secoes.clear();
+        mensagensPorRegra.clear();
+    }
+}
+
+const Snapshot::Secao* Snapshot::secaoAtual(const string& caminhoFonte) const {
+    fs::path caminho(caminhoFonte);
+    string nome = caminho.filename().string();
+
+    for (const Secao& secao : secoes) {
+        if (secao.fonte.nome != nome) {
+            continue;
+        }
+
+        error_code erro;
+        uintmax_t tamanho = fs::file_size(caminho, erro);
+        if (erro || tamanho != secao.fonte.tamanho) {
+            return nullptr;
+        }
+        auto modificacao = fs::last_write_time(caminho, erro);
+        if (!erro && static_cast<int64_t>(modificacao.time_since_epoch().count()) == secao.fonte.modificacao) {
+            return &secao;
+        }
+
+        // Touched but possibly not edited: compare the content itself
+        ArquivoMapeado fonte(caminhoFonte);
+        if (fonte.is_open() && resumo64(fonte.conteudo()) == secao.fonte.resumo) {
+            return &secao;
+        }
+        return nullptr;
+    }
+    return nullptr;
+}
+
+bool Snapshot::carregar(const string& caminhoFonte, CadastroPessoas& destino) const {
+    const Secao* secao = secaoAtual(caminhoFonte);
+    return secao && lerSecao(secao->conteudo, destino);
+}
+
+bool Snapshot::carregar(const string& caminhoFonte, vector<Festa>& destino) const {
+    const Secao* secao = secaoAtual(caminhoFonte);
+    return secao && lerSecao(secao->conteudo, destino);
+}
+
+bool Snapshot::carregar(const string& caminhoFonte, vector<Casamento>& destino) const {
+    const Secao* secao = secaoAtual(caminhoFonte);
+    return secao && lerSecao(secao->conteudo, destino);
+}
+
+bool Snapshot::carregar(const string& caminhoFonte, vector<Lar>& destino) const {
+    const Secao* secao = secaoAtual(caminhoFonte);
+    return secao && lerSecao(secao->conteudo, destino);
+}
+
+bool Snapshot::carregar(const string& caminhoFonte, vector<Tarefa>& destino) const {
+    const Secao* secao = secaoAtual(caminhoFonte);
+    return secao && lerSecao(secao->conteudo, destino);
+}
+
+bool Snapshot::carregar(const string& caminhoFonte, vector<Compra>& destino) const {
+    const Secao* secao = secaoAtual(caminhoFonte);
+    return secao && lerSecao(secao->conteudo, destino);
+}
+
+HistoricoValidacao Snapshot::historico(uint8_t arquivosInalterados) const {
+    return {arquivosInalterados, mensagensPorRegra};
+}
+
+void gravarSnapshot(const string& pasta, const CadastroPessoas& pessoas, const vector<Festa>& festas,
+                    const vector<Casamento>& casamentos, const vector<Lar>& lares,
+                    const vector<Tarefa>& tarefas, const vector<Compra>& compras,
+                    const ResultadoValidacao& validacao) {
+    struct Entrada {
+        FonteSnapshot fonte;
+        string conteudo;
+    };
+    vector<Entrada> entradas;
+
+    auto adicionar = [&](const char* nome, auto gravar) {
+        fs::path caminho = fs::path(pasta) / nome;
+        if (!fs::is_regular_file(caminho)) {
+            return;
+        }
+        ArquivoMapeado fonte(caminho.string());
+        if (!fonte.is_open()) {
+            throw runtime_error("Erro de I/O");
+        }
+        FonteSnapshot identidade{nome, fonte.conteudo().size(), modificacaoDe(caminho), resumo64(fonte.conteudo())};
+        entradas.push_back({move(identidade), gravar()});
+    };
+
+    adicionar("pessoas.csv", [&] { return gravarSecao(pessoas.getPessoas()); });
+    adicionar("festas.csv", [&] { return gravarSecao(festas); });
+    adicionar("casamentos.csv", [&] { return gravarSecao(casamentos); });
+    adicionar("lares.csv", [&] { return gravarSecao(lares); });
+    adicionar("tarefas.csv", [&] { return gravarSecao(tarefas); });
+    adicionar("compras.csv", [&] { return gravarSecao(compras); });
+
+    // Messages each rule printed, kept to be replayed by later runs
+    string mensagens;
+    anexarNumero(mensagens, static_cast<uint32_t>(validacao.mensagensPorRegra.size()));
+    for (const vector<string>& daRegra : validacao.mensagensPorRegra) {
+        anexarNumero(mensagens, static_cast<uint32_t>(daRegra.size()));
+        for (const string& mensagem : daRegra) {
+            anexarTexto(mensagens, mensagem);
+        }
+    }
+
+    // Section table, validation messages, then the sections, with offsets
+    // from the body start
+    string tabela;
+    anexarNumero(tabela, static_cast<uint32_t>(entradas.size()));
+    size_t tamanhoTabela = tabela.size() + mensagens.size();
+    for (const Entrada& entrada : entradas) {
+        tamanhoTabela += sizeof(uint32_t) + entrada.fonte.nome.size() + 5 * sizeof(uint64_t);
+    }
+
+    uint64_t inicio = tamanhoTabela;
+    for (const Entrada& entrada : entradas) {
+        anexarTexto(tabela, entrada.fonte.nome);
+        anexarNumero(tabela, entrada.fonte.tamanho);
+        anexarNumero(tabela, entrada.fonte.modificacao);
+        anexarNumero(tabela, entrada.fonte.resumo);
+        anexarNumero(tabela, inicio);
+        anexarNumero(tabela, static_cast<uint64_t>(entrada.conteudo.size()));
+        inicio += entrada.conteudo.size();
+    }
+
+    string corpo = move(tabela);
+    corpo.reserve(inicio);
+    corpo.append(mensagens);
+    for (const Entrada& entrada : entradas) {
+        corpo.append(entrada.conteudo);
+    }
+
+    gravarArquivoBinario((fs::path(pasta) / Snapshot::NOME_ARQUIVO).string(), string_view(MAGICO, sizeof(MAGICO)),
+                         Snapshot::VERSAO, corpo);
+}
@@ -0,0 +1,68 @@
+#include "Tabelas.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+int32_t mesAbsoluto(const string& data) {
+    try {
+        return parseDateToYearMonth(data).toAbsoluteMonth();
+    } catch (const logic_error&) {
+        return MES_INVALIDO;
+    }
+}
+
+} // namespace
+
+TabelaTarefas::TabelaTarefas(const vector<Tarefa>& tarefas) {
+    size_t n = tarefas.size();
+    idTarefa.reserve(n);
+    idLar.reserve(n);
+    idPrestador.reserve(n);
+    mesInicio.reserve(n);
+    valorPrestador.reserve(n);
+    numParcelas.reserve(n);
+
+    for (const Tarefa& t : tarefas) {
+        idTarefa.push_back(t.getIdTarefa());
+        idLar.push_back(t.getIdLar());
+        idPrestador.push_back(t.getIdPrestador());
+        mesInicio.push_back(mesAbsoluto(t.getDataInicio()));
+        valorPrestador.push_back(t.getValorPrestador());
+        numParcelas.push_back(t.getNumParcelas());
+    }
+}
+
+TabelaCompras::TabelaCompras(const vector<Compra>& compras) {
+    size_t n = compras.size();
+    idTarefa.reserve(n);
+    idLoja.reserve(n);
+    qtdeProduto.reserve(n);
+    precoUnitario.reserve(n);
+    numeroParcelas.reserve(n);
+
+    for (const Compra& c : compras) {
+        idTarefa.push_back(c.getIdTarefa());
+        idLoja.push_back(c.getIdLoja());
+        qtdeProduto.push_back(c.getQtdeProduto());
+        precoUnitario.push_back(c.getPrecoUnitario());
+        numeroParcelas.push_back(c.getNumeroParcelas());
+    }
+}
+
+TabelaFestas::TabelaFestas(const vector<Festa>& festas) {
+    size_t n = festas.size();
+    idCasamento.reserve(n);
+    mesData.reserve(n);
+    valorPago.reserve(n);
+    numParcelas.reserve(n);
+
+    for (const Festa& f : festas) {
+        idCasamento.push_back(f.getIdCasamento());
+        mesData.push_back(mesAbsoluto(f.getData()));
+        valorPago.push_back(f.getValorPago());
+        numParcelas.push_back(f.getNumParcelas());
+    }
+}
@@ -0,0 +1,40 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::executar, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(trava);
+        parando = true;
+    }
+    temTarefa.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::executar() {
+    while (true) {
+        function<void()> tarefa;
+        {
+            unique_lock<mutex> lock(trava);
+            temTarefa.wait(lock, [this]() { return parando || !fila.empty(); });
+            if (fila.empty()) {
+                return;
+            }
+            tarefa = move(fila.front());
+            fila.pop();
+        }
+        tarefa();
+    }
+}
@@ -0,0 +1,261 @@
+#include "Validacao.h"
+
+#include <cstdint>
+
+#include "Instrumentacao.h"
+
+using namespace std;
+
+namespace {
+
+class Validador {
+private:
+    const Registro& registro;
+    ResultadoValidacao& resultado;
+
+    void aviso(string mensagem) {
+        resultado.mensagens.push_back(mensagem);
+        resultado.mensagensPorRegra.back().push_back(move(mensagem));
+    }
+
+    bool falha(string mensagem) {
+        aviso(move(mensagem));
+        resultado.valido = false;
+        return false;
+    }
+
+    // First row (by position) whose ID shows up again later in the list.
+    // One pass keeping the first position of every ID seen so far, in an
+    // array indexed by the (dense) Simbolo handle.
+    template <typename T, typename GetId>
+    bool verificaIdUnico(const vector<T>& itens, GetId getId, const string& classe) {
+        const uint32_t NENHUMA = UINT32_MAX;
+        vector<uint32_t> primeiraPosicao(Simbolo::totalInternados(), NENHUMA);
+        size_t repetido = itens.size();
+
+        for (size_t i = 0; i < itens.size(); i++) {
+            uint32_t& primeira = primeiraPosicao[getId(itens[i]).getHandle()];
+            if (primeira == NENHUMA) {
+                primeira = static_cast<uint32_t>(i);
+            } else if (primeira < repetido) {
+                repetido = primeira;
+            }
+        }
+
+        if (repetido < itens.size()) {
+            return falha("ID repetido: " + getId(itens[repetido]).texto() + " na classe " + classe);
+        }
+        return true;
+    }
+
+    // Marks a handle as seen; false if it already was
+    static bool marcar(vector<bool>& vistos, Simbolo simbolo) {
+        if (vistos[simbolo.getHandle()]) {
+            return false;
+        }
+        vistos[simbolo.getHandle()] = true;
+        return true;
+    }
+
+public:
+    Validador(const Registro& registro, ResultadoValidacao& resultado)
+        : registro(registro), resultado(resultado) {}
+
+    bool verificaIdPessoa() {
+        return verificaIdUnico(registro.getPessoas(), [](const Pessoa* p) { return p->getId(); }, "Pessoa");
+    }
+
+    bool verificaIdLar() {
+        return verificaIdUnico(registro.getLares(), [](const Lar& l) { return l.getIdLar(); }, "Lar");
+    }
+
+    bool verificaIdTarefa() {
+        return verificaIdUnico(registro.getTarefas(), [](const Tarefa& t) { return t.getIdTarefa(); }, "Tarefa");
+    }
+
+    bool verificaIdCasamento() {
+        return verificaIdUnico(registro.getCasamentos(), [](const Casamento& c) { return c.getIdCasamento(); }, "Casamento");
+    }
+
+    bool verificaIdFesta() {
+        return verificaIdUnico(registro.getFestas(), [](const Festa& f) { return f.getId(); }, "Festa");
+    }
+
+    bool verificaIdCompra() {
+        return verificaIdUnico(registro.getCompras(), [](const Compra& c) { return c.getId(); }, "Compra");
+    }
+
+    bool verificaCPFRepetido() {
+        vector<bool> cpfs(Simbolo::totalInternados());
+        for (const Pessoa* p : registro.getPessoas()) {
+            if (p->isPessoaFisica()) {
+                const PessoaFisica* pf = static_cast<const PessoaFisica*>(p);
+                Simbolo cpf = pf->getCpf();
+                if (!marcar(cpfs, cpf)) {
+                    return falha("O CPF " + cpf.texto() + " da Pessoa " + pf->getId().texto() + " é repetido.");
+                }
+            }
+        }
+        return true;
+    }
+
+    // A repeated CNPJ stops the validation for a PJ, but is only reported for a Loja
+    bool verificaCNPJ() {
+        vector<bool> cnpjs(Simbolo::totalInternados());
+        for (const Pessoa* p : registro.getPessoas()) {
+            if (p->isPessoaJuridica()) {
+                Simbolo cnpj = static_cast<const PessoaJuridica*>(p)->getCnpj();
+                if (!marcar(cnpjs, cnpj)) {
+                    return falha("O CNPJ " + cnpj.texto() + " da Pessoa " + p->getId().texto() + " é repetido.");
+                }
+            } else if (p->isLoja()) {
+                Simbolo cnpj = static_cast<const Loja*>(p)->getCnpj();
+                if (!marcar(cnpjs, cnpj)) {
+                    aviso("O CNPJ " + cnpj.texto() + " da Pessoa " + p->getId().texto() + " é repetido.");
+                }
+            }
+        }
+        return true;
+    }
+
+    bool verificaLar() {
+        for (const Lar& lar : registro.getLares()) {
+            for (Simbolo id : {lar.getId1(), lar.getId2()}) {
+                if (!registro.findPessoaById(id)) {
+                    return falha("ID(s) de Pessoa " + id.texto() + " não cadastrado no Lar de ID " + lar.getIdLar().texto());
+                }
+            }
+        }
+        return true;
+    }
+
+    bool verificaCasamento() {
+        for (const Casamento& casamento : registro.getCasamentos()) {
+            for (Simbolo id : {casamento.getId1(), casamento.getId2()}) {
+                if (!registro.findPessoaById(id)) {
+                    return falha("ID(s) de Pessoa " + id.texto() + " não cadastrado no Casamento de ID " + casamento.getIdCasamento().texto());
+                }
+            }
+        }
+        return true;
+    }
+
+    bool verificaTarefaLar() {
+        for (const Tarefa& tarefa : registro.getTarefas()) {
+            Simbolo idLar = tarefa.getIdLar();
+            if (!registro.findLarById(idLar)) {
+                return falha("ID(s) de Lar " + idLar.texto() + " não cadastrado na Tarefa de ID " + tarefa.getIdTarefa().texto());
+            }
+        }
+        return true;
+    }
+
+    bool verificaTarefaPrestador() {
+        for (const Tarefa& tarefa : registro.getTarefas()) {
+            Simbolo idPrestador = tarefa.getIdPrestador();
+            if (!registro.findPessoaById(idPrestador)) {
+                return falha("ID(s) de Prestador de Serviço " + idPrestador.texto() + " não cadastrado na Tarefa de ID " + tarefa.getIdTarefa().texto());
+            }
+        }
+        return true;
+    }
+
+    bool verificaFestaCasamento() {
+        for (const Festa& festa : registro.getFestas()) {
+            Simbolo idCasamento = festa.getIdCasamento();
+            if (!registro.findCasamentoById(idCasamento)) {
+                return falha("ID(s) de Casamento " + idCasamento.texto() + " não cadastrado na Festa de ID " + festa.getId().texto());
+            }
+        }
+        return true;
+    }
+
+    bool verificaCompraTarefa() {
+        for (const Compra& compra : registro.getCompras()) {
+            Simbolo idTarefa = compra.getIdTarefa();
+            if (!registro.findTarefaById(idTarefa)) {
+                return falha("ID(s) de Tarefa " + idTarefa.texto() + " não cadastrado na Compra de ID " + compra.getId().texto());
+            }
+        }
+        return true;
+    }
+
+    bool verificaCompraLoja() {
+        for (const Compra& compra : registro.getCompras()) {
+            Simbolo idLoja = compra.getIdLoja();
+            const Pessoa* p = registro.findPessoaById(idLoja);
+            if (!p) {
+                return falha("ID(s) de Loja " + idLoja.texto() + " não cadastrado na Compra de ID " + compra.getId().texto());
+            } else if (p->isPessoaJuridica() && !p->isLoja()) {
+                return falha("ID " + idLoja.texto() + " da Compra de ID " + compra.getId().texto() + " não se refere a uma Loja, mas a uma PJ.");
+            }
+        }
+        return true;
+    }
+
+    // Starts collecting the messages of the next rule
+    void iniciarRegra() { resultado.mensagensPorRegra.emplace_back(); }
+
+    // Replays a rule from a previous run
+    void repetirRegra(const vector<string>& mensagens) {
+        iniciarRegra();
+        for (const string& mensagem : mensagens) {
+            aviso(mensagem);
+        }
+    }
+};
+
+struct Regra {
+    const char* nome; // For the instrumentation
+    uint8_t arquivos; // Files the rule reads
+    bool (Validador::*verificar)();
+};
+
+// Validation order
+const Regra REGRAS[] = {
+    {"verificaIdPessoa", ARQUIVO_PESSOAS, &Validador::verificaIdPessoa},
+    {"verificaIdLar", ARQUIVO_LARES, &Validador::verificaIdLar},
+    {"verificaIdTarefa", ARQUIVO_TAREFAS, &Validador::verificaIdTarefa},
+    {"verificaIdCasamento", ARQUIVO_CASAMENTOS, &Validador::verificaIdCasamento},
+    {"verificaIdFesta", ARQUIVO_FESTAS, &Validador::verificaIdFesta},
+    {"verificaIdCompra", ARQUIVO_COMPRAS, &Validador::verificaIdCompra},
+    {"verificaCPFRepetido", ARQUIVO_PESSOAS, &Validador::verificaCPFRepetido},
+    {"verificaCNPJ", ARQUIVO_PESSOAS, &Validador::verificaCNPJ},
+    {"verificaLar", ARQUIVO_LARES | ARQUIVO_PESSOAS, &Validador::verificaLar},
+    {"verificaCasamento", ARQUIVO_CASAMENTOS | ARQUIVO_PESSOAS, &Validador::verificaCasamento},
+    {"verificaTarefaLar", ARQUIVO_TAREFAS | ARQUIVO_LARES, &Validador::verificaTarefaLar},
+    {"verificaTarefaPrestador", ARQUIVO_TAREFAS | ARQUIVO_PESSOAS, &Validador::verificaTarefaPrestador},
+    {"verificaFestaCasamento", ARQUIVO_FESTAS | ARQUIVO_CASAMENTOS, &Validador::verificaFestaCasamento},
+    {"verificaCompraTarefa", ARQUIVO_COMPRAS | ARQUIVO_TAREFAS, &Validador::verificaCompraTarefa},
+    {"verificaCompraLoja", ARQUIVO_COMPRAS | ARQUIVO_PESSOAS, &Validador::verificaCompraLoja},
+};
+
+constexpr size_t NUM_REGRAS = sizeof(REGRAS) / sizeof(REGRAS[0]);
+
+} // namespace
+
+ResultadoValidacao validarDados(const Registro& registro, const HistoricoValidacao* historico) {
+    ResultadoValidacao resultado;
+    Validador validador(registro, resultado);
+
+    // A history from another rule set cannot be trusted
+    if (historico && historico->mensagensPorRegra.size() != NUM_REGRAS) {
+        historico = nullptr;
+    }
+
+    for (size_t r = 0; r < NUM_REGRAS; r++) {
+        const Regra& regra = REGRAS[r];
+        if (historico && (regra.arquivos & ~historico->arquivosInalterados) == 0) {
+            validador.repetirRegra(historico->mensagensPorRegra[r]);
+            continue;
+        }
+
+        validador.iniciarRegra();
+        Trecho trecho(regra.nome, "validacao");
+        if (!(validador.*regra.verificar)()) {
+            break;
+        }
+    }
+
+    return resultado;
+}